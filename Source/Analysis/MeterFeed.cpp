@@ -0,0 +1,153 @@
+#include "MeterFeed.h"
+
+MeterFeed::MeterFeed()
+    : frames((size_t)frameCapacity),
+      scopePoints((size_t)scopeCapacity)
+{
+}
+
+void MeterFeed::prepare(double sampleRate)
+{
+    scopeSamplesPerPoint = juce::jmax(1, juce::roundToInt(sampleRate / scopePointsPerSecond));
+    scopeSamplesAccumulated = 0;
+    scopeAccumulator = {};
+    clearPending();
+}
+
+template <typename SampleType>
+void MeterFeed::measure(Point point, const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto numChannels = juce::jmin((int)block.getNumChannels(), maxChannels);
+    const auto numSamples = (int)block.getNumSamples();
+
+    pending.numChannels = numChannels;
+    pendingSamples[point] += numSamples;
+
+    if (numSamples == 0)
+        return;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* data = block.getChannelPointer((size_t)channel);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+        SampleType sumOfSquares = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+            sumOfSquares += data[i] * data[i];
+
+        auto& levels = pending.levels[point][channel];
+        levels.peak = juce::jmax(levels.peak, (float)-range.getStart(), (float)range.getEnd());
+        pendingSumsOfSquares[point][channel] += (float)sumOfSquares;
+    }
+
+    if (point == output)
+        pushScope(block);
+}
+
+template void MeterFeed::measure<float>(Point, const juce::dsp::AudioBlock<float>&) noexcept;
+template void MeterFeed::measure<double>(Point, const juce::dsp::AudioBlock<double>&) noexcept;
+
+void MeterFeed::setDelayTapPeak(int channel, float peak) noexcept
+{
+    if (juce::isPositiveAndBelow(channel, maxChannels))
+        pending.delayTapPeak[channel] = juce::jmax(pending.delayTapPeak[channel], peak);
+}
+
+void MeterFeed::publish() noexcept
+{
+    // The frame covers what reached the output since the last one
+    pending.numSamples = pendingSamples[output];
+
+    for (int point = 0; point < numPoints; ++point)
+        if (pendingSamples[point] > 0)
+            for (int channel = 0; channel < pending.numChannels; ++channel)
+                pending.levels[point][channel].rms = std::sqrt(pendingSumsOfSquares[point][channel] / (float)pendingSamples[point]);
+
+    // A full ring means the editor has stopped reading for now; drop the frame
+    const auto scope = frameFifo.write(1);
+
+    if (scope.blockSize1 > 0)
+        frames[(size_t)scope.startIndex1] = pending;
+
+    clearPending();
+}
+
+void MeterFeed::clearPending() noexcept
+{
+    pending = {};
+    std::fill_n(&pendingSumsOfSquares[0][0], numPoints * maxChannels, 0.0f);
+    std::fill_n(pendingSamples, numPoints, 0);
+}
+
+template <typename SampleType>
+void MeterFeed::pushScope(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto numChannels = (int)block.getNumChannels();
+    const auto numSamples = (int)block.getNumSamples();
+    int sample = 0;
+
+    while (sample < numSamples)
+    {
+        const auto count = juce::jmin(numSamples - sample, scopeSamplesPerPoint - scopeSamplesAccumulated);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer((size_t)channel) + sample, count);
+
+            if (scopeSamplesAccumulated == 0 && channel == 0)
+            {
+                scopeAccumulator = { (float)range.getStart(), (float)range.getEnd() };
+            }
+            else
+            {
+                scopeAccumulator.min = juce::jmin(scopeAccumulator.min, (float)range.getStart());
+                scopeAccumulator.max = juce::jmax(scopeAccumulator.max, (float)range.getEnd());
+            }
+        }
+
+        sample += count;
+        scopeSamplesAccumulated += count;
+
+        if (scopeSamplesAccumulated == scopeSamplesPerPoint)
+        {
+            const auto scope = scopeFifo.write(1);
+
+            if (scope.blockSize1 > 0)
+                scopePoints[(size_t)scope.startIndex1] = scopeAccumulator;
+
+            scopeSamplesAccumulated = 0;
+        }
+    }
+}
+
+void MeterFeed::setActive(bool shouldBeActive) noexcept
+{
+    // Whatever piled up before the editor closed is stale by the time one opens
+    if (shouldBeActive)
+    {
+        frameFifo.read(frameFifo.getNumReady());
+        scopeFifo.read(scopeFifo.getNumReady());
+    }
+
+    active.store(shouldBeActive, std::memory_order_relaxed);
+}
+
+int MeterFeed::readFrames(Frame* dest, int maxFrames) noexcept
+{
+    const auto scope = frameFifo.read(juce::jmin(maxFrames, frameFifo.getNumReady()));
+
+    std::copy_n(frames.begin() + scope.startIndex1, scope.blockSize1, dest);
+    std::copy_n(frames.begin() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+int MeterFeed::readScope(ScopePoint* dest, int maxPoints) noexcept
+{
+    const auto scope = scopeFifo.read(juce::jmin(maxPoints, scopeFifo.getNumReady()));
+
+    std::copy_n(scopePoints.begin() + scope.startIndex1, scope.blockSize1, dest);
+    std::copy_n(scopePoints.begin() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// One-way feed of signal measurements from processBlock to the editor.
+//
+// The audio thread is the only writer and the editor's timer the only reader,
+// so two juce::AbstractFifo rings are enough: one frame of levels per block,
+// and a decimated min/max trace of the output for the scope. Writing never
+// locks or does a read-modify-write; the write side is plain loads and stores,
+// and when a ring is full (nobody reading) the new data is dropped.
+//
+// While no editor is open the feed is inactive and processBlock skips all of it.
+class MeterFeed
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    // Where in the chain a level was taken
+    enum Point
+    {
+        input = 0,      // before the distortion
+        distorted,      // after the distortion
+        output,         // after the delay
+        numPoints
+    };
+
+    struct Levels
+    {
+        float peak = 0.0f;
+        float rms = 0.0f;
+    };
+
+    struct Frame
+    {
+        int numSamples = 0;
+        int numChannels = 0;
+        Levels levels[numPoints][maxChannels];
+        float delayTapPeak[maxChannels] = {};
+    };
+
+    // Output range over scopeSamplesPerPoint samples, all channels
+    struct ScopePoint
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+    };
+
+    static constexpr int frameCapacity = 256;
+    static constexpr int scopeCapacity = 4096;
+    static constexpr double scopePointsPerSecond = 1000.0;
+
+    MeterFeed();
+
+    // Called from prepareToPlay, while the audio thread is stopped
+    void prepare(double sampleRate);
+
+    // Audio thread. Everything measured between two publish() calls goes into
+    // one frame, so a block can be measured a piece at a time as it's processed.
+    // The output measurements also feed the scope trace.
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+    template <typename SampleType>
+    void measure(Point point, const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+    void setDelayTapPeak(int channel, float peak) noexcept;
+    void publish() noexcept;
+
+    // Editor side. setActive(true) when an editor opens, false when it closes.
+    void setActive(bool shouldBeActive) noexcept;
+    int readFrames(Frame* dest, int maxFrames) noexcept;
+    int readScope(ScopePoint* dest, int maxPoints) noexcept;
+
+private:
+    template <typename SampleType>
+    void pushScope(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+    void clearPending() noexcept;
+
+    std::atomic<bool> active { false };
+
+    juce::AbstractFifo frameFifo { frameCapacity };
+    std::vector<Frame> frames;
+    Frame pending;
+    float pendingSumsOfSquares[numPoints][maxChannels] {};
+    int pendingSamples[numPoints] {};
+
+    juce::AbstractFifo scopeFifo { scopeCapacity };
+    std::vector<ScopePoint> scopePoints;
+    ScopePoint scopeAccumulator;
+    int scopeSamplesPerPoint = 48;
+    int scopeSamplesAccumulated = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterFeed)
+};
\ No newline at end of file
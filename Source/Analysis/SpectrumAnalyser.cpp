@@ -0,0 +1,263 @@
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("Spectrum analyser"),
+      fftData((size_t)fftSize * 2)
+{
+    for (auto& state : signals)
+    {
+        state.ring.resize((size_t)ringSize);
+        state.history.resize((size_t)fftSize);
+    }
+
+    prepare(currentSampleRate);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stopThread(1000);
+}
+
+void SpectrumAnalyser::prepare(double sampleRate)
+{
+    // The bands depend on the rate, so the thread mustn't be reading them meanwhile
+    const bool wasRunning = isThreadRunning();
+    stopThread(1000);
+
+    currentSampleRate = sampleRate;
+
+    // Log-spaced band edges from minFrequency to Nyquist, in FFT bins. Low bands
+    // narrower than a bin share it with their neighbours.
+    const auto nyquist = (float)sampleRate * 0.5f;
+
+    for (int edge = 0; edge <= numBands; ++edge)
+    {
+        const auto frequency = minFrequency * std::pow(nyquist / minFrequency, (float)edge / (float)numBands);
+        bandEdges[(size_t)edge] = juce::jlimit(1, fftSize / 2, juce::roundToInt(frequency * (float)fftSize / (float)sampleRate));
+    }
+
+    resetState();
+
+    if (wasRunning)
+        startThread(juce::Thread::Priority::low);
+}
+
+void SpectrumAnalyser::resetState()
+{
+    // The audio thread may still be finishing a push, so the fifo is drained
+    // from the reading end rather than reset. The analysis thread is stopped
+    // whenever this runs, which leaves this the only reader.
+    for (auto& state : signals)
+    {
+        state.fifo.read(state.fifo.getNumReady());
+        std::fill(state.history.begin(), state.history.end(), 0.0f);
+        state.spectrum.level.fill(floorDb);
+        state.spectrum.peak.fill(floorDb);
+        state.peakHoldSeconds.fill(0.0f);
+    }
+
+    const juce::ScopedLock lock(resultLock);
+
+    for (auto& spectrum : result)
+    {
+        spectrum.level.fill(floorDb);
+        spectrum.peak.fill(floorDb);
+    }
+
+    hasNewResult = true;
+}
+
+float SpectrumAnalyser::getBandFrequency(int band) const noexcept
+{
+    const auto nyquist = (float)currentSampleRate * 0.5f;
+    return minFrequency * std::pow(nyquist / minFrequency, ((float)band + 0.5f) / (float)numBands);
+}
+
+template <typename SampleType>
+void SpectrumAnalyser::push(Signal signal, const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    auto& state = signals[(size_t)signal];
+    const auto numChannels = (int)block.getNumChannels();
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (numChannels == 0)
+        return;
+
+    // Whatever doesn't fit is dropped; the thread will catch up on the next block.
+    // The ring is float whatever the block holds; the display needs no more.
+    const auto scope = state.fifo.write(numSamples);
+    const auto channelGain = (SampleType)1 / (SampleType)numChannels;
+
+    const auto copySegment = [&](int start, int size, int offset)
+    {
+        if (size <= 0)
+            return;
+
+        auto* dest = state.ring.data() + start;
+        const auto* first = block.getChannelPointer(0) + offset;
+
+        for (int i = 0; i < size; ++i)
+            dest[i] = (float)(first[i] * channelGain);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+        {
+            const auto* source = block.getChannelPointer((size_t)channel) + offset;
+
+            for (int i = 0; i < size; ++i)
+                dest[i] += (float)(source[i] * channelGain);
+        }
+    };
+
+    copySegment(scope.startIndex1, scope.blockSize1, 0);
+    copySegment(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+template void SpectrumAnalyser::push<float>(Signal, const juce::dsp::AudioBlock<float>&) noexcept;
+template void SpectrumAnalyser::push<double>(Signal, const juce::dsp::AudioBlock<double>&) noexcept;
+
+void SpectrumAnalyser::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == isActive())
+        return;
+
+    if (shouldBeActive)
+    {
+        // Start from silence rather than whatever was left from last time
+        resetState();
+        active.store(true, std::memory_order_relaxed);
+        startThread(juce::Thread::Priority::low);
+    }
+    else
+    {
+        active.store(false, std::memory_order_relaxed);
+        stopThread(1000);
+    }
+}
+
+bool SpectrumAnalyser::getLatest(std::array<Spectrum, numSignals>& dest)
+{
+    const juce::ScopedLock lock(resultLock);
+
+    if (! hasNewResult)
+        return false;
+
+    dest = result;
+    hasNewResult = false;
+    return true;
+}
+
+void SpectrumAnalyser::run()
+{
+    const auto intervalMs = 1000.0 / maxRefreshHz;
+    auto lastAnalysis = juce::Time::getMillisecondCounterHiRes();
+
+    while (! threadShouldExit())
+    {
+        const auto now = juce::Time::getMillisecondCounterHiRes();
+        const auto elapsedSeconds = (float)((now - lastAnalysis) / 1000.0);
+        lastAnalysis = now;
+
+        bool analysed = false;
+
+        for (auto& state : signals)
+        {
+            if (readNewSamples(state))
+            {
+                analyse(state, elapsedSeconds);
+                analysed = true;
+            }
+        }
+
+        if (analysed)
+        {
+            const juce::ScopedLock lock(resultLock);
+
+            for (size_t signal = 0; signal < signals.size(); ++signal)
+                result[signal] = signals[signal].spectrum;
+
+            hasNewResult = true;
+        }
+
+        // Cap the rate, whatever the host's block size
+        const auto spent = juce::Time::getMillisecondCounterHiRes() - now;
+        wait(juce::jmax(1, (int)(intervalMs - spent)));
+    }
+}
+
+bool SpectrumAnalyser::readNewSamples(SignalState& state)
+{
+    const auto numReady = state.fifo.getNumReady();
+
+    if (numReady == 0)
+        return false;
+
+    // Slide the history along and append the new samples; only the newest
+    // fftSize samples matter if more than that arrived
+    const auto numToKeep = juce::jmax(0, fftSize - numReady);
+    const auto numToSkip = juce::jmax(0, numReady - fftSize);
+
+    if (numToKeep > 0)
+        std::copy(state.history.end() - numToKeep, state.history.end(), state.history.begin());
+
+    const auto scope = state.fifo.read(numReady);
+    auto* dest = state.history.data() + numToKeep;
+    int skipped = 0;
+
+    const auto copySegment = [&](int start, int size)
+    {
+        const auto skip = juce::jmin(size, numToSkip - skipped);
+        skipped += skip;
+        std::copy_n(state.ring.data() + start + skip, size - skip, dest);
+        dest += size - skip;
+    };
+
+    copySegment(scope.startIndex1, scope.blockSize1);
+    copySegment(scope.startIndex2, scope.blockSize2);
+    return true;
+}
+
+void SpectrumAnalyser::analyse(SignalState& state, float elapsedSeconds)
+{
+    std::copy(state.history.begin(), state.history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full-scale sine has magnitude fftSize / 2 before the window, which halves it
+    const auto normalisation = 4.0f / (float)fftSize;
+
+    const auto levelFall = levelFallDbPerSecond * elapsedSeconds;
+    const auto peakFall = peakFallDbPerSecond * elapsedSeconds;
+
+    for (size_t band = 0; band < (size_t)numBands; ++band)
+    {
+        const auto first = bandEdges[band];
+        const auto last = juce::jmax(first + 1, bandEdges[band + 1]);
+        float magnitude = 0.0f;
+
+        for (int bin = first; bin < last; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[(size_t)bin]);
+
+        const auto db = juce::Decibels::gainToDecibels(magnitude * normalisation, floorDb);
+
+        // Rise instantly, fall at a fixed rate
+        auto& level = state.spectrum.level[band];
+        level = juce::jmax(db, level - levelFall);
+
+        auto& peak = state.spectrum.peak[band];
+        auto& hold = state.peakHoldSeconds[band];
+
+        if (level >= peak)
+        {
+            peak = level;
+            hold = peakHoldSeconds;
+        }
+        else if (hold > 0.0f)
+        {
+            hold -= elapsedSeconds;
+        }
+        else
+        {
+            peak = juce::jmax(level, peak - peakFall);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Input and output spectrum for the editor.
+//
+// processBlock only copies a mono mix of each signal into a lock-free ring.
+// Everything else happens on a low-priority background thread, at most
+// maxRefreshHz times a second: Hann windowing, the FFT, grouping the bins into
+// log-spaced bands, and level/peak-hold ballistics. The editor polls the latest
+// result. The thread only runs, and processBlock only copies, while the
+// analyser is active, i.e. while the spectrum view is on screen.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBands = 160;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float floorDb = -100.0f;
+    static constexpr int maxRefreshHz = 30;
+
+    enum Signal
+    {
+        input = 0,      // before the distortion
+        output,         // after the delay
+        numSignals
+    };
+
+    struct Spectrum
+    {
+        std::array<float, numBands> level;   // dB, 0 dB = full-scale sine
+        std::array<float, numBands> peak;    // dB, held then falling
+    };
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    // Called from prepareToPlay, while the audio thread is stopped
+    void prepare(double sampleRate);
+
+    // Audio thread
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+    template <typename SampleType>
+    void push(Signal signal, const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // Editor side
+    void setActive(bool shouldBeActive);
+
+    // Copies the latest spectra; false when nothing new was analysed since the last call
+    bool getLatest(std::array<Spectrum, numSignals>& dest);
+
+    // Centre frequency of a band, in Hz
+    float getBandFrequency(int band) const noexcept;
+
+private:
+    struct SignalState
+    {
+        juce::AbstractFifo fifo { ringSize };
+        std::vector<float> ring;
+        std::vector<float> history;     // last fftSize samples, oldest first
+        Spectrum spectrum;
+        std::array<float, numBands> peakHoldSeconds;
+    };
+
+    static constexpr int ringSize = 1 << 15;   // over a refresh period at 192 kHz, with headroom
+    static constexpr float levelFallDbPerSecond = 60.0f;
+    static constexpr float peakHoldSeconds = 1.0f;
+    static constexpr float peakFallDbPerSecond = 20.0f;
+
+    void run() override;
+    bool readNewSamples(SignalState& state);
+    void analyse(SignalState& state, float elapsedSeconds);
+    void resetState();
+
+    std::atomic<bool> active { false };
+    double currentSampleRate = 44100.0;
+
+    std::array<SignalState, numSignals> signals;
+    std::array<int, numBands + 1> bandEdges {};     // first FFT bin of each band
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;
+
+    juce::CriticalSection resultLock;
+    std::array<Spectrum, numSignals> result;
+    bool hasNewResult = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
\ No newline at end of file
@@ -0,0 +1,558 @@
+#include "ConvolutionStage.h"
+
+namespace
+{
+    // Long enough to hide the switch between two IRs, short enough to feel immediate
+    constexpr double crossfadeSeconds = 0.05;
+
+    constexpr double parameterRampSeconds = 0.05;
+}
+
+//==============================================================================
+// The per-instance half of a convolution: input history, the frequency-domain
+// delay line and FFT scratch for one IR at one channel count. The IR itself is
+// shared. An engine without a response is a bypass, used to fade an IR out.
+class ConvolutionStage::Engine
+{
+public:
+    Engine() = default;
+
+    Engine(std::shared_ptr<const ImpulseResponse> impulseResponse, int numChannels)
+        : response(std::move(impulseResponse))
+    {
+        constexpr auto partitionSize = ImpulseResponse::partitionSize;
+        const auto directLength = response->getDirectLength();
+        const auto fdlSize = (size_t)(response->getNumPartitions() * ImpulseResponse::numBins);
+
+        channels.resize((size_t)numChannels);
+
+        for (auto& state : channels)
+        {
+            state.history.resize((size_t)(directLength - 1 + partitionSize));
+
+            if (fdlSize > 0)
+            {
+                state.inputChunk.resize((size_t)partitionSize);
+                state.previousChunk.resize((size_t)partitionSize);
+                state.outputChunk.resize((size_t)partitionSize);
+                state.fdlReal.resize(fdlSize);
+                state.fdlImag.resize(fdlSize);
+                state.nextReal.resize((size_t)ImpulseResponse::numBins);
+                state.nextImag.resize((size_t)ImpulseResponse::numBins);
+            }
+        }
+
+        if (fdlSize > 0)
+        {
+            fft = std::make_unique<juce::dsp::FFT>(ImpulseResponse::fftOrder);
+            fftData.resize((size_t)ImpulseResponse::fftSize * 2);
+        }
+    }
+
+    bool hasResponse() const noexcept { return response != nullptr; }
+    int getLength() const noexcept { return response != nullptr ? response->getLength() : 0; }
+
+    void reset() noexcept
+    {
+        for (auto& state : channels)
+            for (auto* buffer : { &state.history, &state.inputChunk, &state.previousChunk, &state.outputChunk,
+                                  &state.fdlReal, &state.fdlImag, &state.nextReal, &state.nextImag })
+                std::fill(buffer->begin(), buffer->end(), 0.0f);
+
+        chunkFill = 0;
+        fdlIndex = 0;
+        nextPartition = 1;
+    }
+
+    // Writes the convolution of input to output (which must not overlap it)
+    void process(const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& output) noexcept
+    {
+        constexpr auto partitionSize = ImpulseResponse::partitionSize;
+        const auto numChannels = juce::jmin((int)input.getNumChannels(), (int)channels.size());
+        const auto numSamples = (int)input.getNumSamples();
+        const auto numPartitions = response->getNumPartitions();
+
+        // Segments end where a partition's worth of input is complete
+        for (int offset = 0; offset < numSamples;)
+        {
+            const auto segment = juce::jmin(numSamples - offset, partitionSize - chunkFill);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto& state = channels[(size_t)channel];
+                const auto irChannel = juce::jmin(channel, response->getNumChannels() - 1);
+                const auto* in = input.getChannelPointer((size_t)channel) + offset;
+                auto* out = output.getChannelPointer((size_t)channel) + offset;
+
+                convolveDirect(state, irChannel, in, out, segment);
+
+                if (numPartitions > 0)
+                {
+                    std::copy_n(in, segment, state.inputChunk.data() + chunkFill);
+                    juce::FloatVectorOperations::add(out, state.outputChunk.data() + chunkFill, segment);
+                }
+            }
+
+            offset += segment;
+            chunkFill += segment;
+
+            if (numPartitions > 0)
+            {
+                // The older partitions' share of the next chunk's output, in
+                // step with the chunk filling up, so the work doesn't all land
+                // on the sub-block that completes it
+                const auto upTo = 1 + (numPartitions - 1) * chunkFill / partitionSize;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    accumulatePartitions(channels[(size_t)channel], juce::jmin(channel, response->getNumChannels() - 1), upTo);
+
+                nextPartition = upTo;
+            }
+
+            if (chunkFill == partitionSize)
+            {
+                if (numPartitions > 0)
+                {
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        convolvePartitions(channels[(size_t)channel], juce::jmin(channel, response->getNumChannels() - 1));
+
+                    fdlIndex = (fdlIndex + 1) % numPartitions;
+                    nextPartition = 1;
+                }
+
+                chunkFill = 0;
+            }
+        }
+    }
+
+private:
+    struct ChannelState
+    {
+        std::vector<float> history;          // last directLength - 1 inputs, then the segment
+        std::vector<float> inputChunk;       // the partition being filled
+        std::vector<float> previousChunk;    // the one before, for overlap-save
+        std::vector<float> outputChunk;      // FFT part's output for the partition being filled
+        std::vector<float> fdlReal, fdlImag; // spectra of the last numPartitions input chunks
+        std::vector<float> nextReal, nextImag; // the next output's spectrum, partitions 1 and up so far
+    };
+
+    // One multiply-add over the whole segment per tap
+    void convolveDirect(ChannelState& state, int irChannel, const float* in, float* out, int numSamples) noexcept
+    {
+        const auto directLength = response->getDirectLength();
+        const auto* taps = response->getDirectTaps(irChannel);
+        auto* history = state.history.data();
+
+        std::copy_n(in, numSamples, history + directLength - 1);
+        juce::FloatVectorOperations::clear(out, numSamples);
+
+        for (int tap = 0; tap < directLength; ++tap)
+            juce::FloatVectorOperations::addWithMultiply(out, history + directLength - 1 - tap, taps[tap], numSamples);
+
+        std::copy(history + numSamples, history + numSamples + directLength - 1, history);
+    }
+
+    // Partition p meets the input from p chunks before the one being filled.
+    // Every partition but the first only needs chunks already transformed, so
+    // these are summed while the current chunk fills, up to partition upTo.
+    void accumulatePartitions(ChannelState& state, int irChannel, int upTo) noexcept
+    {
+        constexpr auto numBins = ImpulseResponse::numBins;
+        const auto numPartitions = response->getNumPartitions();
+        auto* accReal = state.nextReal.data();
+        auto* accImag = state.nextImag.data();
+
+        for (int partition = nextPartition; partition < upTo; ++partition)
+        {
+            const auto slot = (fdlIndex - partition + numPartitions) % numPartitions;
+            multiplyAccumulate(accReal, accImag,
+                               state.fdlReal.data() + slot * numBins, state.fdlImag.data() + slot * numBins,
+                               response->getPartitionReal(irChannel, partition), response->getPartitionImag(irChannel, partition));
+        }
+    }
+
+    static void multiplyAccumulate(float* accReal, float* accImag, const float* xReal, const float* xImag,
+                                   const float* hReal, const float* hImag) noexcept
+    {
+        for (int bin = 0; bin < ImpulseResponse::numBins; ++bin)
+        {
+            accReal[bin] += xReal[bin] * hReal[bin] - xImag[bin] * hImag[bin];
+            accImag[bin] += xReal[bin] * hImag[bin] + xImag[bin] * hReal[bin];
+        }
+    }
+
+    // Runs once per completed chunk, after accumulatePartitions() has covered
+    // the rest: transform it, add its product with the first partition, and
+    // transform back the output for the next chunk
+    void convolvePartitions(ChannelState& state, int irChannel) noexcept
+    {
+        constexpr auto partitionSize = ImpulseResponse::partitionSize;
+        constexpr auto fftSize = ImpulseResponse::fftSize;
+        constexpr auto numBins = ImpulseResponse::numBins;
+        auto* data = fftData.data();
+
+        std::copy_n(state.previousChunk.data(), partitionSize, data);
+        std::copy_n(state.inputChunk.data(), partitionSize, data + partitionSize);
+        std::fill(data + fftSize, data + fftSize * 2, 0.0f);
+        fft->performRealOnlyForwardTransform(data, true);
+
+        auto* newestReal = state.fdlReal.data() + fdlIndex * numBins;
+        auto* newestImag = state.fdlImag.data() + fdlIndex * numBins;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            newestReal[bin] = data[bin * 2];
+            newestImag[bin] = data[bin * 2 + 1];
+        }
+
+        auto* accReal = state.nextReal.data();
+        auto* accImag = state.nextImag.data();
+        multiplyAccumulate(accReal, accImag, newestReal, newestImag,
+                           response->getPartitionReal(irChannel, 0), response->getPartitionImag(irChannel, 0));
+
+        // Back to interleaved, with the conjugate-symmetric upper half filled in
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            data[bin * 2] = accReal[bin];
+            data[bin * 2 + 1] = accImag[bin];
+        }
+
+        for (int bin = numBins; bin < fftSize; ++bin)
+        {
+            data[bin * 2] = accReal[fftSize - bin];
+            data[bin * 2 + 1] = -accImag[fftSize - bin];
+        }
+
+        // Emptied for the partitions of the chunk after
+        std::fill(accReal, accReal + numBins, 0.0f);
+        std::fill(accImag, accImag + numBins, 0.0f);
+        fft->performRealOnlyInverseTransform(data);
+
+        // Overlap-save: only the second half is free of wrap-around
+        std::copy_n(data + partitionSize, partitionSize, state.outputChunk.data());
+        std::copy_n(state.inputChunk.data(), partitionSize, state.previousChunk.data());
+    }
+
+    std::shared_ptr<const ImpulseResponse> response;
+    std::vector<ChannelState> channels;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fftData;
+    int chunkFill = 0;
+    int fdlIndex = 0;
+    int nextPartition = 1;     // the first partition accumulatePartitions() hasn't done yet
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Engine)
+};
+
+//==============================================================================
+class ConvolutionStage::LoadJob : public juce::ThreadPoolJob
+{
+public:
+    LoadJob(ConvolutionStage& stage, const juce::File& fileToLoad, double rate, int channels)
+        : juce::ThreadPoolJob("Load IR"),
+          owner(stage),
+          file(fileToLoad),
+          sampleRate(rate),
+          numChannels(channels)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        juce::String error;
+        auto response = owner.library->get(file, sampleRate, error);
+
+        if (shouldExit())
+            return jobHasFinished;
+
+        owner.collectGarbage();
+
+        if (response == nullptr)
+        {
+            // Play dry rather than carry on with an IR the user replaced
+            owner.publish(std::make_unique<Engine>());
+            owner.setStatus({ State::failed, file, error, {} });
+            return jobHasFinished;
+        }
+
+        owner.publish(std::make_unique<Engine>(response, numChannels));
+        owner.setStatus({ State::ready, file, response->getName(), response });
+        return jobHasFinished;
+    }
+
+private:
+    ConvolutionStage& owner;
+    const juce::File file;
+    const double sampleRate;
+    const int numChannels;
+};
+
+//==============================================================================
+ConvolutionStage::ConvolutionStage() = default;
+
+ConvolutionStage::~ConvolutionStage()
+{
+    if (job != nullptr)
+        library->getLoaderThread().removeJob(job.get(), true, -1);
+
+    collectGarbage();
+    delete pending.exchange(nullptr);
+}
+
+void ConvolutionStage::prepare(const juce::dsp::ProcessSpec& spec, bool waitForLoad)
+{
+    const juce::ScopedLock lock(loadLock);
+
+    if (job != nullptr)
+        library->getLoaderThread().removeJob(job.get(), true, -1);
+
+    collectGarbage();
+
+    // The audio thread is stopped, so everything it owns can be settled here
+    if (auto* next = pending.exchange(nullptr))
+        active.reset(next);
+
+    fadingOut.reset();
+    fading = false;
+
+    const auto formatChanged = spec.sampleRate != currentSampleRate || (int)spec.numChannels != numChannels;
+    currentSampleRate = spec.sampleRate;
+    numChannels = (int)spec.numChannels;
+
+    dryBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+    wetBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+    fadeBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+
+    mix.reset(spec.sampleRate, parameterRampSeconds);
+    snapToTargets = true;
+    fadeLength = juce::jmax(1, (int)(crossfadeSeconds * spec.sampleRate));
+
+    const auto current = getStatus();
+
+    if (formatChanged)
+    {
+        // The engine is for the old rate; play dry until the IR is ready again
+        active.reset();
+
+        if (current.state == State::ready || current.state == State::loading)
+            startLoading(current.file);
+    }
+    else
+    {
+        if (active != nullptr)
+            active->reset();
+
+        if (current.state == State::loading)
+            startLoading(current.file);
+    }
+
+    // Offline there's no deadline to keep, and a render that starts dry and
+    // crossfades the IR in partway through wouldn't be repeatable
+    if (waitForLoad && job != nullptr)
+    {
+        library->getLoaderThread().waitForJobToFinish(job.get(), -1);
+
+        if (auto* next = pending.exchange(nullptr))
+            active.reset(next);
+    }
+}
+
+void ConvolutionStage::load(const juce::File& file)
+{
+    const juce::ScopedLock lock(loadLock);
+
+    if (job != nullptr)
+        library->getLoaderThread().removeJob(job.get(), true, -1);
+
+    collectGarbage();
+
+    // Before the first prepare() there's no rate to load at; prepare() starts it
+    if (currentSampleRate > 0.0)
+        startLoading(file);
+    else
+        setStatus({ State::loading, file, {}, {} });
+}
+
+void ConvolutionStage::unload()
+{
+    const juce::ScopedLock lock(loadLock);
+
+    if (job != nullptr)
+        library->getLoaderThread().removeJob(job.get(), true, -1);
+
+    collectGarbage();
+
+    if (getStatus().state == State::empty)
+        return;
+
+    setStatus({});
+    publish(std::make_unique<Engine>());
+}
+
+void ConvolutionStage::startLoading(const juce::File& file)
+{
+    setStatus({ State::loading, file, {}, {} });
+    job = std::make_unique<LoadJob>(*this, file, currentSampleRate, numChannels);
+    library->getLoaderThread().addJob(job.get(), false);
+}
+
+ConvolutionStage::Status ConvolutionStage::getStatus() const
+{
+    const juce::ScopedLock lock(statusLock);
+    return status;
+}
+
+void ConvolutionStage::setStatus(Status newStatus)
+{
+    const juce::ScopedLock lock(statusLock);
+    status = std::move(newStatus);
+}
+
+void ConvolutionStage::publish(std::unique_ptr<Engine> engine)
+{
+    loadedLength.store(engine->getLength(), std::memory_order_relaxed);
+
+    // An engine the audio thread never picked up can simply go
+    delete pending.exchange(engine.release());
+}
+
+void ConvolutionStage::collectGarbage()
+{
+    for (auto& slot : retired)
+        delete slot.exchange(nullptr);
+}
+
+void ConvolutionStage::setMix(float newMix) noexcept
+{
+    if (snapToTargets)
+    {
+        mix.setCurrentAndTargetValue(newMix);
+        snapToTargets = false;
+        return;
+    }
+
+    mix.setTargetValue(newMix);
+}
+
+bool ConvolutionStage::isActive() const noexcept
+{
+    return (active != nullptr && active->hasResponse()) || fading || pending.load() != nullptr;
+}
+
+int ConvolutionStage::getTailSamples() const noexcept
+{
+    const auto activeLength = active != nullptr ? active->getLength() : 0;
+    return fading && fadingOut != nullptr ? juce::jmax(activeLength, fadingOut->getLength()) : activeLength;
+}
+
+void ConvolutionStage::runEngine(Engine* engine, const juce::dsp::AudioBlock<float>& input,
+                                 juce::dsp::AudioBlock<float>& output) noexcept
+{
+    if (engine != nullptr && engine->hasResponse())
+        engine->process(input, output);
+    else
+        output.copyFrom(input);
+}
+
+template <typename SampleType>
+void ConvolutionStage::process(juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto channelsToProcess = juce::jmin((int)block.getNumChannels(), numChannels);
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (channelsToProcess == 0 || numSamples == 0)
+        return;
+
+    // Take a newly loaded engine, as long as there's a slot to hand the old one back through
+    auto* freeSlot = std::find_if(retired.begin(), retired.end(), [](auto& slot) { return slot.load() == nullptr; });
+
+    if (! fading && freeSlot != retired.end())
+    {
+        if (auto* next = pending.exchange(nullptr))
+        {
+            fadingOut.reset(active.release());
+            active.reset(next);
+            fading = true;
+            fadePosition = 0;
+            fadeSlot = freeSlot;
+        }
+    }
+
+    const auto maxBlockSize = dryBuffer.getNumSamples();
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        const auto length = juce::jmin(maxBlockSize, numSamples - offset);
+        auto target = block.getSubBlock((size_t)offset, (size_t)length).getSubsetChannelBlock(0, (size_t)channelsToProcess);
+
+        auto dry = juce::dsp::AudioBlock<float>(dryBuffer).getSubBlock(0, (size_t)length).getSubsetChannelBlock(0, (size_t)channelsToProcess);
+        auto wet = juce::dsp::AudioBlock<float>(wetBuffer).getSubBlock(0, (size_t)length).getSubsetChannelBlock(0, (size_t)channelsToProcess);
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            const auto* input = target.getChannelPointer((size_t)channel);
+            std::copy(input, input + length, dry.getChannelPointer((size_t)channel));
+        }
+
+        runEngine(active.get(), dry, wet);
+
+        if (fading)
+        {
+            // Old engine out, new one in, both running on the same input
+            auto old = juce::dsp::AudioBlock<float>(fadeBuffer).getSubBlock(0, (size_t)length).getSubsetChannelBlock(0, (size_t)channelsToProcess);
+            runEngine(fadingOut.get(), dry, old);
+
+            for (int channel = 0; channel < channelsToProcess; ++channel)
+            {
+                auto* wetData = wet.getChannelPointer((size_t)channel);
+                const auto* oldData = old.getChannelPointer((size_t)channel);
+
+                for (int i = 0; i < length; ++i)
+                {
+                    const auto position = juce::jmin(1.0f, (float)(fadePosition + i) / (float)fadeLength);
+                    wetData[i] = oldData[i] + (wetData[i] - oldData[i]) * position;
+                }
+            }
+
+            fadePosition += length;
+
+            if (fadePosition >= fadeLength)
+            {
+                fading = false;
+                fadeSlot->store(fadingOut.release());
+            }
+        }
+
+        // out = dry * (1 - mix) + wet * mix, with the dry part still in the target
+        if (! mix.isSmoothing())
+        {
+            const auto wetAmount = (SampleType)mix.getTargetValue();
+            const auto dryAmount = 1 - wetAmount;
+
+            for (int channel = 0; channel < channelsToProcess; ++channel)
+            {
+                auto* out = target.getChannelPointer((size_t)channel);
+                const auto* wetData = wet.getChannelPointer((size_t)channel);
+
+                for (int i = 0; i < length; ++i)
+                    out[i] = out[i] * dryAmount + (SampleType)wetData[i] * wetAmount;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < length; ++i)
+            {
+                const auto wetAmount = (SampleType)mix.getNextValue();
+
+                for (int channel = 0; channel < channelsToProcess; ++channel)
+                {
+                    const auto dryValue = target.getSample(channel, i);
+                    target.setSample(channel, i, dryValue + ((SampleType)wet.getSample(channel, i) - dryValue) * wetAmount);
+                }
+            }
+        }
+    }
+}
+
+template void ConvolutionStage::process<float>(juce::dsp::AudioBlock<float>&) noexcept;
+template void ConvolutionStage::process<double>(juce::dsp::AudioBlock<double>&) noexcept;
\ No newline at end of file
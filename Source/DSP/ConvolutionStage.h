@@ -0,0 +1,113 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ImpulseResponse.h"
+
+// Convolution with a user-loaded impulse response, for cabinet simulation and
+// rooms. It adds no latency.
+//
+// The IR's first taps run as a direct-form FIR, one vectorised multiply-add
+// over the block per tap. IRs up to ImpulseResponse::maxDirectLength taps are
+// handled by the FIR alone. Longer IRs go through uniformly partitioned
+// overlap-save FFT convolution for everything after the first partition. The
+// FIR covers exactly the partition the FFT part is a block late for, so no
+// latency is added. Only the first partition has to wait for a chunk to
+// complete; the others' multiply-adds are spread over the blocks that fill it.
+//
+// load() returns at once. The file is decoded, resampled to the current rate
+// and partitioned on the ImpulseResponseLibrary's loader thread, shared with
+// every other instance that loads the same file. The finished engine is
+// handed to the audio thread through an atomic pointer and crossfaded in. The
+// engine it replaces comes back the same way, to be freed off the audio
+// thread by the next load(), unload() or prepare().
+class ConvolutionStage
+{
+public:
+    enum class State
+    {
+        empty,
+        loading,
+        ready,
+        failed
+    };
+
+    struct Status
+    {
+        State state = State::empty;
+        juce::File file;
+        juce::String message;                               // IR name, or why it failed
+        std::shared_ptr<const ImpulseResponse> response;
+    };
+
+    ConvolutionStage();
+    ~ConvolutionStage();
+
+    // Called from prepareToPlay, while the audio thread is stopped. A new rate
+    // or channel count reloads the IR in the background. With waitForLoad, as
+    // for an offline render, any load in progress finishes and its engine is
+    // installed before this returns, so the first block is already convolved.
+    void prepare(const juce::dsp::ProcessSpec& spec, bool waitForLoad = false);
+
+    // Message thread (or any thread but the audio thread)
+    void load(const juce::File& file);
+    void unload();
+    Status getStatus() const;
+
+    // Wet/dry balance, smoothed
+    void setMix(float mix) noexcept;
+
+    // Convolves the block in place. With no IR loaded it passes the block through.
+    // The engines run in float; a double block keeps its dry signal in double
+    // and only the wet part goes through float.
+    template <typename SampleType>
+    void process(juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // False while there's no IR, nothing pending and no crossfade; process() can be skipped then
+    bool isActive() const noexcept;
+
+    // Audio thread: how long the output can ring on after the input goes
+    // silent, the longest of the IRs playing
+    int getTailSamples() const noexcept;
+
+    // Any thread, without locking: the length in samples of the IR last handed
+    // to the audio thread, or 0 for none. For the host's tail length query.
+    int getLoadedLength() const noexcept { return loadedLength.load(std::memory_order_relaxed); }
+
+private:
+    class Engine;
+    class LoadJob;
+
+    void publish(std::unique_ptr<Engine> engine);
+    void setStatus(Status newStatus);
+    void collectGarbage();
+    void startLoading(const juce::File& file);
+    void runEngine(Engine* engine, const juce::dsp::AudioBlock<float>& input, juce::dsp::AudioBlock<float>& output) noexcept;
+
+    juce::SharedResourcePointer<ImpulseResponseLibrary> library;
+
+    // Audio thread only: the engine playing, and the one being faded out
+    std::unique_ptr<Engine> active, fadingOut;
+    int fadePosition = 0, fadeLength = 0;
+    bool fading = false;
+    std::atomic<Engine*>* fadeSlot = nullptr;   // where fadingOut goes when the fade ends
+
+    // Hand-over points between the loader and audio threads. A few retired
+    // slots, so a quick run of loads never finds them all waiting to be collected.
+    std::atomic<Engine*> pending { nullptr };
+    std::array<std::atomic<Engine*>, 4> retired {};
+    std::atomic<int> loadedLength { 0 };
+
+    juce::AudioBuffer<float> dryBuffer, wetBuffer, fadeBuffer;
+    juce::SmoothedValue<float> mix;
+    bool snapToTargets = true;   // the first mix after prepare() applies without a ramp
+    double currentSampleRate = 0.0;
+    int numChannels = 0;
+
+    juce::CriticalSection loadLock;     // serialises load()/unload()/prepare()
+    std::unique_ptr<LoadJob> job;
+
+    mutable juce::CriticalSection statusLock;
+    Status status;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvolutionStage)
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "DistortionStage.h"
+
+namespace
+{
+    constexpr double parameterRampSeconds = 0.05;
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // Index 0 is the 1x setting and doesn't need an oversampler
+    for (int order = 1; order <= maxOversamplingOrder; ++order)
+    {
+        auto oversampler = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+            (size_t)spec.numChannels,
+            (size_t)order,
+            juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple,
+            true,   // max quality
+            true);  // integer latency, so the host can compensate it exactly
+
+        oversampler->initProcessing((size_t)spec.maximumBlockSize);
+        oversamplers[(size_t)order] = std::move(oversampler);
+    }
+
+    waveShaper.prepare((int)spec.numChannels);
+
+    amountSmoother.reset(spec.sampleRate, parameterRampSeconds);
+    gainSmoother.reset(spec.sampleRate, parameterRampSeconds);
+    gainRamp.resize((size_t)spec.maximumBlockSize);
+
+    reset();
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::reset()
+{
+    for (auto& oversampler : oversamplers)
+        if (oversampler != nullptr)
+            oversampler->reset();
+
+    waveShaper.reset();
+    snapToTargets = true;
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::setParameters(float amount, int type, float outputGain)
+{
+    shaperType = type;
+
+    if (snapToTargets)
+    {
+        amountSmoother.setCurrentAndTargetValue(amount);
+        gainSmoother.setCurrentAndTargetValue(outputGain);
+        snapToTargets = false;
+        return;
+    }
+
+    amountSmoother.setTargetValue(amount);
+    gainSmoother.setTargetValue(outputGain);
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::setOversamplingOrder(int order)
+{
+    order = juce::jlimit(0, maxOversamplingOrder, order);
+
+    if (order == oversamplingOrder)
+        return;
+
+    oversamplingOrder = order;
+
+    // Don't let the filters ring out whatever they held the last time this factor was used
+    if (auto& oversampler = oversamplers[(size_t)order])
+        oversampler->reset();
+
+    // The ADAA history was recorded at the old rate
+    waveShaper.reset();
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::setAntialiasingOrder(int order)
+{
+    waveShaper.setAntialiasingOrder(order);
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::process(juce::dsp::AudioBlock<SampleType>& block)
+{
+    const auto numSamples = (int)block.getNumSamples();
+
+    // A steady gain folds into the shaper's output scale; a moving one is applied afterwards
+    const bool gainIsRamping = gainSmoother.isSmoothing();
+    const float shaperGain = gainIsRamping ? 1.0f : gainSmoother.getTargetValue();
+
+    if (amountSmoother.isSmoothing())
+    {
+        for (int start = 0; start < numSamples; start += controlBlockSize)
+        {
+            const int length = juce::jmin(controlBlockSize, numSamples - start);
+            auto subBlock = block.getSubBlock((size_t)start, (size_t)length);
+
+            amountSmoother.skip(length);
+            waveShaper.setParameters(amountSmoother.getCurrentValue(), shaperType);
+            processShaper(subBlock, shaperGain);
+        }
+    }
+    else
+    {
+        waveShaper.setParameters(amountSmoother.getTargetValue(), shaperType);
+        processShaper(block, shaperGain);
+    }
+
+    if (gainIsRamping)
+    {
+        const auto rampLength = juce::jmin(numSamples, (int)gainRamp.size());
+
+        for (int i = 0; i < rampLength; ++i)
+            gainRamp[(size_t)i] = (SampleType)gainSmoother.getNextValue();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            juce::FloatVectorOperations::multiply(block.getChannelPointer(channel), gainRamp.data(), rampLength);
+    }
+}
+
+template <typename SampleType>
+void DistortionStage<SampleType>::processShaper(juce::dsp::AudioBlock<SampleType>& block, float shaperGain)
+{
+    auto* oversampler = oversamplers[(size_t)oversamplingOrder].get();
+
+    if (oversampler == nullptr)
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+            waveShaper.process((int)channel, block.getChannelPointer(channel), (int)block.getNumSamples(), shaperGain);
+
+        return;
+    }
+
+    auto oversampledBlock = oversampler->processSamplesUp(block);
+
+    for (size_t channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
+        waveShaper.process((int)channel, oversampledBlock.getChannelPointer(channel), (int)oversampledBlock.getNumSamples(), shaperGain);
+
+    oversampler->processSamplesDown(block);
+}
+
+template <typename SampleType>
+int DistortionStage<SampleType>::getLatencySamples() const noexcept
+{
+    return getLatencySamples(oversamplingOrder, waveShaper.getAntialiasingOrder());
+}
+
+template <typename SampleType>
+int DistortionStage<SampleType>::getLatencySamples(int oversampling, int antialiasing) const noexcept
+{
+    oversampling = juce::jlimit(0, maxOversamplingOrder, oversampling);
+
+    // ADAA delays by half a sample per order at the oversampled rate
+    float latency = WaveShaper::getAntialiasingDelay(antialiasing) / (float)(1 << oversampling);
+
+    if (auto* oversampler = oversamplers[(size_t)oversampling].get())
+        latency += oversampler->getLatencyInSamples();
+
+    return juce::roundToInt(latency);
+}
+
+template class DistortionStage<float>;
+template class DistortionStage<double>;
\ No newline at end of file
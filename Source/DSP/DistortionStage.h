@@ -0,0 +1,63 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveShaper.h"
+
+// Waveshaper plus output gain, optionally run at 2x/4x/8x the host rate and/or
+// with antiderivative anti-aliasing.
+//
+// One oversampler per factor is built in prepare(), so switching factor on the
+// audio thread never allocates. The FIR half-band filters are linear phase and
+// padded to a whole number of samples, so their latency is exact; the half
+// sample per ADAA order is rounded into the reported figure.
+//
+// Amount and gain changes are smoothed. Gain ramps per sample. The amount ramps
+// per control block, because every step recomputes the shaper's drive and
+// output scale; once it settles the block runs in one piece again.
+//
+// The oversampling filters and the gain ramp run in SampleType; the shaper
+// itself takes either.
+template <typename SampleType>
+class DistortionStage
+{
+public:
+    static constexpr int maxOversamplingOrder = 3;  // 2^3 = 8x
+    static constexpr int controlBlockSize = 32;     // host samples per amount step while smoothing
+
+    DistortionStage() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset();
+
+    // Sets the targets the amount and gain glide to; the type switches immediately
+    void setParameters(float amount, int type, float outputGain);
+
+    // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    void setOversamplingOrder(int order);
+    int getOversamplingOrder() const noexcept { return oversamplingOrder; }
+
+    // 0 = off, 1 = first order ADAA, 2 = second order ADAA
+    void setAntialiasingOrder(int order);
+
+    void process(juce::dsp::AudioBlock<SampleType>& block);
+
+    int getLatencySamples() const noexcept;
+
+    // The latency at the given orders, whichever is in use. Only reads the
+    // filters built in prepare(), so the message thread can ask while playing.
+    int getLatencySamples(int oversampling, int antialiasing) const noexcept;
+
+private:
+    void processShaper(juce::dsp::AudioBlock<SampleType>& block, float shaperGain);
+
+    WaveShaper waveShaper;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxOversamplingOrder + 1> oversamplers;
+    int oversamplingOrder = 0;
+    int shaperType = 0;
+
+    juce::SmoothedValue<float> amountSmoother, gainSmoother;
+    std::vector<SampleType> gainRamp;
+    bool snapToTargets = true;   // the first targets after reset() apply without a ramp
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DistortionStage)
+};
\ No newline at end of file
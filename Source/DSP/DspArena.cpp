@@ -0,0 +1,88 @@
+#include "DspArena.h"
+
+void DspArena::allocate(std::initializer_list<size_t> sectionSizes)
+{
+    jassert((int)sectionSizes.size() <= maxSections);
+    release();
+
+    size_t offset = 0;
+
+    for (auto sectionSize : sectionSizes)
+    {
+        if (numSections == maxSections)
+            break;
+
+        auto& section = sections[(size_t)numSections++];
+        section.offset = offset;
+        section.size = sectionSize;
+        offset += (sectionSize + alignment - 1) & ~(alignment - 1);
+    }
+
+    size = offset;
+
+    if (size == 0)
+        return;
+
+    // Over-allocate by one alignment step so the first section can start on a cache line
+    block.calloc(size + alignment);
+    const auto address = reinterpret_cast<juce::pointer_sized_uint>(block.get());
+    base = block.get() + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+}
+
+void DspArena::release()
+{
+    for (auto& section : sections)
+    {
+        section.claimedBytes.store(0, std::memory_order_release);
+        section.offset = 0;
+        section.size = 0;
+    }
+
+    numSections = 0;
+    size = 0;
+    base = nullptr;
+    block.free();
+}
+
+void DspArena::claim(int section)
+{
+    if (juce::isPositiveAndBelow(section, numSections))
+        claim(section, sections[(size_t)section].size, 1);
+}
+
+void DspArena::claim(int section, size_t bytesPerPart, int numParts)
+{
+    if (! juce::isPositiveAndBelow(section, numSections) || numParts <= 0)
+        return;
+
+    auto& target = sections[(size_t)section];
+    const auto partSize = target.size / (size_t)numParts;
+    const auto claimed = target.claimedBytes.load(std::memory_order_relaxed);
+    bytesPerPart = juce::jmin(bytesPerPart, partSize);
+
+    if (bytesPerPart <= claimed)
+        return;
+
+    // Writing the zero calloc promised makes the OS back each page now, rather
+    // than on the audio thread's first write. volatile keeps the writes in.
+    // Parts don't start on page boundaries, so the pages are stepped through
+    // by address: one write at the start of the new range, one on every page
+    // boundary inside it, and one on its last byte. Every write stays inside
+    // the range, clear of anything already claimed and in use.
+    for (int part = 0; part < numParts; ++part)
+    {
+        auto* data = base + target.offset + (size_t)part * partSize;
+        auto* start = data + claimed;
+        auto* end = data + bytesPerPart;
+        const auto address = reinterpret_cast<juce::pointer_sized_uint>(start);
+
+        *static_cast<volatile char*>(start) = 0;
+
+        for (auto* page = start + (pageSize - (address & (pageSize - 1))); page < end; page += pageSize)
+            *static_cast<volatile char*>(page) = 0;
+
+        *static_cast<volatile char*>(end - 1) = 0;
+    }
+
+    target.claimedBytes.store(bytesPerPart, std::memory_order_release);
+}
\ No newline at end of file
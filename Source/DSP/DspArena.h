@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// One allocation holding the delay memory of every stage in a processor.
+//
+// allocate() lays out one section per stage and gets a single zeroed block for
+// all of them, each section starting on a cache line. The block comes from
+// calloc, which for sizes like these maps fresh pages without writing to them,
+// so a section costs address space but no RAM until it's claimed. claim()
+// touches every page of a section, so the audio thread never takes a first-use
+// page fault, then publishes it. A stage that's never used is never claimed.
+//
+// A section can also be claimed in part and grown later. It's split into
+// equal parts, one per channel say, and only the first so many bytes of each
+// part are touched, so a stage laid out for its worst case only costs RAM for
+// what it uses now.
+//
+// allocate(), claim() and release() belong to whoever prepares the processor
+// and must not overlap one another. The audio thread only calls getSection(),
+// which gives nullptr until the section has been claimed.
+class DspArena
+{
+public:
+    static constexpr int maxSections = 8;
+    static constexpr size_t alignment = 64;
+
+    DspArena() = default;
+
+    // Frees any previous block, then allocates one with a section of each size in bytes
+    void allocate(std::initializer_list<size_t> sectionSizes);
+    void release();
+
+    // Pre-faults a section's pages and hands it to the audio thread. Does nothing the second time.
+    void claim(int section);
+
+    // Pre-faults the first bytesPerPart of each of numParts equal parts of a
+    // section. Claiming more later only touches the pages not yet touched;
+    // claiming less does nothing.
+    void claim(int section, size_t bytesPerPart, int numParts);
+
+    bool isClaimed(int section) const noexcept
+    {
+        return getClaimedBytes(section) > 0;
+    }
+
+    // How much of each part has been claimed so far
+    size_t getClaimedBytes(int section) const noexcept
+    {
+        return sections[(size_t)section].claimedBytes.load(std::memory_order_acquire);
+    }
+
+    // A claimed section's memory, all zero when first claimed; nullptr before that
+    template <typename Type>
+    Type* getSection(int section) const noexcept
+    {
+        if (! isClaimed(section))
+            return nullptr;
+
+        return reinterpret_cast<Type*>(base + sections[(size_t)section].offset);
+    }
+
+private:
+    // Touched once per page; 4 kB is the smallest page any of our targets uses
+    static constexpr size_t pageSize = 4096;
+
+    struct Section
+    {
+        size_t offset = 0;
+        size_t size = 0;
+        std::atomic<size_t> claimedBytes { 0 };   // per part
+    };
+
+    juce::HeapBlock<char> block;
+    char* base = nullptr;
+    size_t size = 0;
+    std::array<Section, maxSections> sections;
+    int numSections = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspArena)
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Reorderable effects chain with every order built at compile time.
+//
+// The chain is numSlots slots, each a group of effects that moves as one. The
+// owner provides a member template processSlot<slot>(block) for each slot.
+// EffectChain turns every permutation of the slots into its own function,
+// which calls the owner's slot processors in that order directly so each one
+// can inline. Choosing an order at run time chooses one of those functions,
+// once per block: the stages themselves and their per-sample loops never
+// see the order, and an effect added as a new slot only adds work where it runs.
+//
+// Orders are numbered lexicographically, so order 0 is the slots in their
+// declared order.
+template <typename Owner, typename SampleType, int numSlots>
+class EffectChain
+{
+public:
+    using Block = juce::dsp::AudioBlock<SampleType>;
+    using Order = std::array<int, (size_t)numSlots>;
+
+    static constexpr int getNumOrders() noexcept
+    {
+        int count = 1;
+
+        for (int n = 2; n <= numSlots; ++n)
+            count *= n;
+
+        return count;
+    }
+
+    static constexpr int numOrders = getNumOrders();
+
+    // The slots in the order with the given number
+    static constexpr Order getOrder(int index) noexcept
+    {
+        Order order {};
+        bool used[numSlots] {};
+        int remaining = getNumOrders();
+
+        for (int position = 0; position < numSlots; ++position)
+        {
+            // Each choice at this position covers an equal run of the orders after it
+            remaining /= numSlots - position;
+            auto skip = index / remaining;
+            index %= remaining;
+
+            for (int slot = 0; slot < numSlots; ++slot)
+            {
+                if (used[slot])
+                    continue;
+
+                if (skip-- == 0)
+                {
+                    order[(size_t)position] = slot;
+                    used[slot] = true;
+                    break;
+                }
+            }
+        }
+
+        return order;
+    }
+
+    // Runs the block through every slot in the chosen order
+    static void process(Owner& owner, int orderIndex, Block& block)
+    {
+        runners[(size_t)juce::jlimit(0, numOrders - 1, orderIndex)](owner, block);
+    }
+
+private:
+    using Runner = void (*)(Owner&, Block&);
+
+    template <int index, int... positions>
+    static void run(Owner& owner, Block& block, std::integer_sequence<int, positions...>)
+    {
+        (owner.template processSlot<getOrder(index)[(size_t)positions]>(block), ...);
+    }
+
+    template <int index>
+    static void run(Owner& owner, Block& block)
+    {
+        run<index>(owner, block, std::make_integer_sequence<int, numSlots> {});
+    }
+
+    template <int... indices>
+    static constexpr std::array<Runner, (size_t)numOrders> makeRunners(std::integer_sequence<int, indices...>)
+    {
+        return { { &run<indices>... } };
+    }
+
+    static constexpr std::array<Runner, (size_t)numOrders> runners = makeRunners(std::make_integer_sequence<int, numOrders> {});
+};
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "FdnReverb.h"
+
+namespace
+{
+    // Line lengths at full size, in seconds. No two share a common period, so
+    // echoes from different lines don't stack into flutter or a pitched ring.
+    constexpr float baseLengths[FdnReverb<float>::numLines] = { 0.0297f, 0.0371f, 0.0411f, 0.0437f,
+                                                         0.0533f, 0.0571f, 0.0617f, 0.0683f };
+
+    constexpr float maxBaseLength = 0.0683f;
+    constexpr float meanBaseLength = (0.0297f + 0.0371f + 0.0411f + 0.0437f + 0.0533f + 0.0571f + 0.0617f + 0.0683f) / 8.0f;
+
+    // Wet level at mix 1: a steady signal's tail sits around 7 dB below it
+    constexpr float wetGain = 2.0f;
+
+    // Size 0 is a small room at a fifth of the full lengths
+    constexpr float minSizeScale = 0.2f;
+
+    // Damping 0 leaves the loop open to 20 kHz, 1 closes it down to 1 kHz
+    constexpr float maxDampingCutoff = 20000.0f;
+    constexpr float minDampingCutoff = 1000.0f;
+
+    constexpr double sizeRampSeconds = 0.2;
+    constexpr double mixRampSeconds = 0.05;
+
+    float getSizeScale(float size)
+    {
+        return minSizeScale + (1.0f - minSizeScale) * juce::jlimit(0.0f, 1.0f, size);
+    }
+
+    float getDampingCoefficient(float damping, double sampleRate)
+    {
+        const auto cutoff = juce::jmin(maxDampingCutoff * std::pow(minDampingCutoff / maxDampingCutoff, juce::jlimit(0.0f, 1.0f, damping)),
+                                       0.45f * (float)sampleRate);
+
+        return std::exp(-juce::MathConstants<float>::twoPi * cutoff / (float)sampleRate);
+    }
+
+    // Entry (row, column) of the 8x8 Sylvester Hadamard matrix, scaled to be orthogonal
+    float hadamard(int row, int column)
+    {
+        const auto sign = (juce::countNumberOfBits((juce::uint32)(row & column)) & 1) != 0 ? -1.0f : 1.0f;
+        return sign / std::sqrt((float)FdnReverb<float>::numLines);
+    }
+}
+
+template <typename SampleType>
+typename FdnReverb<SampleType>::Vector FdnReverb<SampleType>::load(const SampleType* source) noexcept
+{
+    Vector result;
+
+    for (int r = 0; r < numRegisters; ++r)
+        result[(size_t)r] = Register::fromRawArray(source + r * lanes);
+
+    return result;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    // One interleaved frame per sample of the longest line, plus the interpolator's
+    // extra tap. The ring waits for setStorage(); the old storage may be gone.
+    const auto maxLength = (int)std::ceil(maxBaseLength * sampleRate) + 2;
+    mask = juce::nextPowerOfTwo(maxLength) - 1;
+    ring = nullptr;
+
+    // The matrix and the input/output patterns never change, so build them once.
+    // Rows 1 and 2 feed the left and right inputs in, rows 3 and 5 take the
+    // outputs, keeping the stereo image wide without either side dominating.
+    alignas(Register::SIMDRegisterSize) SampleType values[numLines];
+
+    const auto loadRow = [&values](int row)
+    {
+        for (int line = 0; line < numLines; ++line)
+            values[line] = (SampleType)hadamard(row, line);
+
+        return load(values);
+    };
+
+    for (int column = 0; column < numLines; ++column)
+    {
+        for (int row = 0; row < numLines; ++row)
+            values[row] = (SampleType)hadamard(row, column);
+
+        matrixColumns[(size_t)column] = load(values);
+    }
+
+    leftInput = loadRow(1);
+    rightInput = loadRow(2);
+    leftOutput = loadRow(3);
+    rightOutput = loadRow(5);
+
+    size.reset(sampleRate, sizeRampSeconds);
+    mix.reset(sampleRate, mixRampSeconds);
+
+    reset();
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::setStorage(SampleType* storage) noexcept
+{
+    static_assert(sizeof(Frame) == sizeof(SampleType) * numLines, "Frames must pack into the storage");
+    jassert(reinterpret_cast<juce::pointer_sized_uint>(storage) % alignof(Frame) == 0);
+
+    ring = reinterpret_cast<Frame*>(storage);
+    writeIndex = 0;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::reset() noexcept
+{
+    clear();
+    snapToTargets = true;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::clear() noexcept
+{
+    if (ring != nullptr)
+        std::fill(ring, ring + mask + 1, Frame {});
+
+    writeIndex = 0;
+    dampingStates = {};
+    needsClear = false;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::setParameters(float newSize, float newDecaySeconds, float newDamping, float newMix) noexcept
+{
+    const bool snapped = snapToTargets;
+
+    if (snapToTargets)
+    {
+        size.setCurrentAndTargetValue(newSize);
+        mix.setCurrentAndTargetValue(newMix);
+
+        for (int line = 0; line < numLines; ++line)
+            lengths[line] = baseLengths[line] * getSizeScale(newSize) * (float)currentSampleRate;
+
+        snapToTargets = false;
+    }
+    else
+    {
+        size.setTargetValue(newSize);
+        mix.setTargetValue(newMix);
+    }
+
+    if (snapped || newDecaySeconds != decaySeconds || newDamping != damping)
+    {
+        decaySeconds = juce::jmax(0.01f, newDecaySeconds);
+        damping = newDamping;
+        dampingCoefficient = getDampingCoefficient(damping, currentSampleRate);
+        gainsChanged = true;
+    }
+}
+
+template <typename SampleType>
+bool FdnReverb<SampleType>::isActive() const noexcept
+{
+    return ring != nullptr && (mix.getTargetValue() > 0.0f || mix.isSmoothing());
+}
+
+template <typename SampleType>
+double FdnReverb<SampleType>::getTailSeconds(float size, float decaySeconds, float floorDb) noexcept
+{
+    // Every line falls 60 dB in the decay time, after the longest one's first pass
+    return juce::jmax(0.01f, decaySeconds) * floorDb / -60.0 + maxBaseLength * getSizeScale(size);
+}
+
+template <typename SampleType>
+float FdnReverb<SampleType>::getDecaySeconds(float size, float decaySeconds, float damping, float frequency, double sampleRate)
+{
+    // Loss per trip round an average line: the decay gain plus the lowpass at this frequency
+    const auto passSeconds = meanBaseLength * getSizeScale(size);
+    const auto d = getDampingCoefficient(damping, sampleRate);
+    const auto w = juce::MathConstants<float>::twoPi * frequency / (float)sampleRate;
+    const auto lowpassGain = (1.0f - d) / std::sqrt(1.0f - 2.0f * d * std::cos(w) + d * d);
+
+    const auto passDb = -60.0f * passSeconds / decaySeconds + juce::Decibels::gainToDecibels(lowpassGain, -200.0f);
+    return passDb < 0.0f ? -60.0f * passSeconds / passDb : decaySeconds;
+}
+
+template <typename SampleType>
+bool FdnReverb<SampleType>::updateLengths(int numSamples) noexcept
+{
+    if (! size.isSmoothing())
+        return false;
+
+    // Glide from the current lengths to where the size will be at the end of the block
+    const auto scale = getSizeScale(size.skip(numSamples)) * (float)currentSampleRate;
+
+    for (int line = 0; line < numLines; ++line)
+        lengthSteps[line] = (baseLengths[line] * scale - lengths[line]) / (float)numSamples;
+
+    gainsChanged = true;
+    return true;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::updateGains() noexcept
+{
+    // Each line loses 60 dB over decaySeconds, whatever its length. Using the
+    // lengths at the start of the block is close enough while the size glides.
+    alignas(Register::SIMDRegisterSize) SampleType gains[numLines];
+    float meanSquare = 0.0f;
+
+    for (int line = 0; line < numLines; ++line)
+    {
+        const auto gain = std::pow(10.0f, -3.0f * lengths[line] / (decaySeconds * (float)currentSampleRate));
+        gains[line] = (SampleType)gain;
+        meanSquare += gain * gain / (float)numLines;
+    }
+
+    decayGains = load(gains);
+
+    // The tail's energy grows as 1 / (1 - g^2) with the decay time; scale it
+    // back so long and short decays come out at a similar loudness
+    outputGain = wetGain * std::sqrt(1.0f - meanSquare);
+    gainsChanged = false;
+}
+
+template <typename SampleType>
+void FdnReverb<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto numChannels = juce::jmin((int)block.getNumChannels(), 2);
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (ring == nullptr || numChannels == 0 || numSamples == 0)
+        return;
+
+    // Coming back after a rest starts from silence, not the old tail
+    if (needsClear)
+        clear();
+
+    const auto gliding = updateLengths(numSamples);
+
+    if (gainsChanged)
+        updateGains();
+
+    auto* left = block.getChannelPointer(0);
+    auto* right = numChannels > 1 ? block.getChannelPointer(1) : nullptr;
+
+    const auto d = Register::expand((SampleType)dampingCoefficient);
+
+    alignas(Register::SIMDRegisterSize) SampleType taps[numLines];
+    alignas(Register::SIMDRegisterSize) SampleType feedback[numLines];
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // The only scalar part: one linearly interpolated tap per line
+        for (int line = 0; line < numLines; ++line)
+        {
+            const auto length = lengths[line];
+            const auto whole = (int)length;
+            const auto fraction = (SampleType)(length - (float)whole);
+            const auto newer = ring[(size_t)((writeIndex - whole) & mask)].lines[line];
+            const auto older = ring[(size_t)((writeIndex - whole - 1) & mask)].lines[line];
+            taps[line] = newer + fraction * (older - newer);
+        }
+
+        if (gliding)
+            for (int line = 0; line < numLines; ++line)
+                lengths[line] += lengthSteps[line];
+
+        const auto inLeft = left[sample];
+        const auto inRight = right != nullptr ? right[sample] : inLeft;
+
+        // Damp, take the outputs, then apply the decay gains
+        auto x = load(taps);
+        auto wetLeft = Register::expand(0), wetRight = Register::expand(0);
+
+        for (size_t r = 0; r < (size_t)numRegisters; ++r)
+        {
+            dampingStates[r] = x[r] + (dampingStates[r] - x[r]) * d;
+            wetLeft += dampingStates[r] * leftOutput[r];
+            wetRight += dampingStates[r] * rightOutput[r];
+            (dampingStates[r] * decayGains[r]).copyToRawArray(feedback + r * lanes);
+        }
+
+        // Matrix step, one broadcast column at a time, plus the new input
+        Vector y;
+
+        for (size_t r = 0; r < (size_t)numRegisters; ++r)
+            y[r] = leftInput[r] * Register::expand(inLeft) + rightInput[r] * Register::expand(inRight);
+
+        for (int column = 0; column < numLines; ++column)
+        {
+            const auto value = Register::expand(feedback[column]);
+
+            for (size_t r = 0; r < (size_t)numRegisters; ++r)
+                y[r] += matrixColumns[(size_t)column][r] * value;
+        }
+
+        auto& frame = ring[(size_t)writeIndex];
+
+        for (size_t r = 0; r < (size_t)numRegisters; ++r)
+            y[r].copyToRawArray(frame.lines + r * lanes);
+
+        writeIndex = (writeIndex + 1) & mask;
+
+        const auto wet = (SampleType)mix.getNextValue();
+        const auto dry = 1 - wet;
+        const auto gain = (SampleType)outputGain;
+        left[sample] = inLeft * dry + wetLeft.sum() * gain * wet;
+
+        if (right != nullptr)
+            right[sample] = inRight * dry + wetRight.sum() * gain * wet;
+    }
+
+    // Once the mix is fully down the caller stops calling, so clear on the way back
+    if (! isActive())
+        needsClear = true;
+}
+
+template class FdnReverb<float>;
+template class FdnReverb<double>;
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LaneRegister.h"
+
+// Feedback delay network reverb with eight delay lines.
+//
+// The eight lines share one interleaved ring: frame n holds sample n of every
+// line side by side, so a sample's feedback vector (damping, decay gains,
+// mixing matrix and input injection) goes through the SIMD registers in one
+// pass and is written back with one aligned store. Only the eight tap reads
+// are scalar, because every line has its own length.
+//
+// The feedback matrix is an 8x8 Hadamard matrix scaled to be orthogonal, so
+// the loop is lossless before the per-line decay gains. Each line has a
+// one-pole lowpass in the loop for damping. The gains are derived from each
+// line's length so that all lines fall by 60 dB in the decay time.
+//
+// The ring lives in caller-owned storage, sized in prepare(). Size changes
+// glide the line lengths across the block, read with linear interpolation, so
+// sweeping the size pitches the tail rather than clicking.
+//
+// The network runs in SampleType, so at double precision a register holds
+// half as many lines and the loop takes twice the passes.
+template <typename SampleType>
+class FdnReverb
+{
+public:
+    static constexpr int numLines = 8;
+
+    FdnReverb() = default;
+
+    void prepare(double sampleRate);
+    void reset() noexcept;
+
+    // Samples of storage the ring needs after prepare(). setStorage() takes it
+    // zeroed and aligned to a cache line, or nullptr to let go of it; the
+    // reverb is inactive without any.
+    int getRequiredStorage() const noexcept { return (mask + 1) * numLines; }
+    void setStorage(SampleType* storage) noexcept;
+    bool hasStorage() const noexcept { return ring != nullptr; }
+
+    // size 0..1, decay = RT60 in seconds, damping 0..1, mix 0..1
+    void setParameters(float size, float decaySeconds, float damping, float mix) noexcept;
+
+    // Reverberates a mono or stereo block in place:
+    // out = in * (1 - mix) + reverb * mix. Channels past the second pass through dry.
+    void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // False once the mix has faded to zero, or with no storage; processing can be skipped then
+    bool isActive() const noexcept;
+
+    // RT60 at a given frequency, taking the damping filters into account.
+    // The editor uses this to draw the decay curves.
+    static float getDecaySeconds(float size, float decaySeconds, float damping, float frequency, double sampleRate);
+
+    // How long the tail takes to fall from full scale to floorDb once the
+    // input goes silent. Damping only shortens it.
+    static double getTailSeconds(float size, float decaySeconds, float floorDb) noexcept;
+
+private:
+    using Register = LaneRegister<SampleType>;
+
+    static constexpr int lanes = (int)Register::SIMDNumElements;
+    static constexpr int numRegisters = numLines / lanes;
+    static_assert(numLines % lanes == 0, "The lines must fill whole SIMD registers");
+
+    // One sample of every line, aligned for the SIMD loads and stores
+    struct alignas(Register::SIMDRegisterSize) Frame
+    {
+        SampleType lines[numLines];
+    };
+
+    using Vector = std::array<Register, numRegisters>;
+
+    void clear() noexcept;
+    bool updateLengths(int numSamples) noexcept;
+    void updateGains() noexcept;
+    static Vector load(const SampleType* source) noexcept;
+
+    Frame* ring = nullptr;
+    int mask = 0;
+    int writeIndex = 0;
+    double currentSampleRate = 44100.0;
+
+    // Line lengths in samples now, and the step per sample while gliding (see updateLengths())
+    alignas(Register::SIMDRegisterSize) float lengths[numLines] {};
+    alignas(Register::SIMDRegisterSize) float lengthSteps[numLines] {};
+
+    // Feedback state: per-line decay gains and lowpass memories
+    Vector decayGains {}, dampingStates {};
+    float dampingCoefficient = 0.0f;
+    float outputGain = 1.0f;
+
+    // Matrix columns, and the input and output patterns (rows of the same matrix)
+    std::array<Vector, numLines> matrixColumns {};
+    Vector leftInput {}, rightInput {};
+    Vector leftOutput {}, rightOutput {};
+
+    juce::SmoothedValue<float> size, mix;
+    float decaySeconds = 1.5f;
+    float damping = 0.5f;
+    bool gainsChanged = true;
+    bool needsClear = false;
+    bool snapToTargets = true;   // the first settings after reset() apply without a ramp
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FdnReverb)
+};
\ No newline at end of file
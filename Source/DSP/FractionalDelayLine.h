@@ -0,0 +1,304 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Fractional delay line over a power-of-two ring buffer.
+//
+// The ring is owned by the caller (see MultiChannelDelay), so several effects
+// can read taps out of the same memory. Reads happen before the write for the
+// current sample, so the shortest usable delay is minimumDelay samples.
+//
+// While the delay is settled, readBlock() and the write pointer let a caller
+// handle a whole run of samples with straight loops: getContiguousRun() says
+// how far it can go before a tap or the write head would wrap, or a read would
+// reach a sample written in the same run.
+//
+// Interpolation is chosen per block through the template argument of read(),
+// keeping the per-sample path free of mode switches:
+//  - linear:   2 taps, cheapest, dulls the top end at half-sample fractions
+//  - lagrange: 4 taps, 3rd order Lagrange, flat to well above 10 kHz at 44.1 kHz
+//  - thiran:   1st order allpass, flat magnitude but stateful, so best for
+//              slowly moving delays
+template <typename SampleType>
+class FractionalDelayLine
+{
+public:
+    enum class Interpolation
+    {
+        linear = 0,
+        lagrange,
+        thiran
+    };
+
+    static constexpr int minimumDelay = 2;
+
+    // Smallest power-of-two ring that can hold maxDelaySamples plus the interpolator's taps
+    static int getRequiredStorage(int maxDelaySamples)
+    {
+        return juce::nextPowerOfTwo(maxDelaySamples + 4);
+    }
+
+    void setStorage(SampleType* data, int size) noexcept
+    {
+        jassert(juce::isPowerOfTwo(size));
+        ring = data;
+        mask = size - 1;
+        writeIndex = 0;
+        allpassState = 0;
+    }
+
+    // Takes a larger ring at the same address, whose first samples are the
+    // current ring and whose rest is still zero. The part of the history that
+    // had wrapped round moves up to the new end, so every delay that fitted
+    // before reads back the same samples. Costs one pass over that part.
+    void grow(int newSize) noexcept
+    {
+        jassert(juce::isPowerOfTwo(newSize) && newSize > mask + 1);
+
+        const auto oldSize = mask + 1;
+        const auto shift = newSize - oldSize;
+
+        std::copy_backward(ring + writeIndex, ring + oldSize, ring + oldSize + shift);
+        std::fill(ring + writeIndex, ring + juce::jmin(writeIndex + shift, oldSize), SampleType());
+        mask = newSize - 1;
+    }
+
+    void reset() noexcept
+    {
+        if (ring != nullptr)
+            std::fill(ring, ring + mask + 1, SampleType());
+
+        writeIndex = 0;
+        allpassState = 0;
+        delaySmoother.setCurrentAndTargetValue(delaySmoother.getTargetValue());
+    }
+
+    // Zeroes numSamples of the history, starting with the sample written age
+    // samples ago and moving towards the newest. The rest of the ring is kept.
+    void clearHistory(int age, int numSamples) noexcept
+    {
+        jassert(age <= mask + 1 && numSamples <= age);
+        auto index = (writeIndex - age) & mask;
+
+        while (numSamples > 0)
+        {
+            const auto run = juce::jmin(numSamples, mask + 1 - index);
+            std::fill(ring + index, ring + index + run, SampleType());
+            index = (index + run) & mask;
+            numSamples -= run;
+        }
+    }
+
+    // Delay changes glide over rampSeconds instead of jumping, so moving the
+    // delay time bends the pitch briefly rather than clicking
+    void prepareSmoothing(double sampleRate, double rampSeconds) noexcept
+    {
+        glideLength = (int)std::floor(sampleRate * rampSeconds);
+        rampLength = glideLength;
+        delaySmoother.reset(rampLength);
+    }
+
+    void setDelay(SampleType delayInSamples) noexcept
+    {
+        setDelay(delayInSamples, glideLength);
+    }
+
+    // Moves to the new delay over exactly rampLengthInSamples samples. Used to
+    // follow a host tempo ramp one block at a time without lagging behind it.
+    void setDelay(SampleType delayInSamples, int rampLengthInSamples) noexcept
+    {
+        delayInSamples = juce::jlimit((SampleType)minimumDelay, getMaxDelay(), delayInSamples);
+
+        // The first delay after prepare() is taken as-is rather than glided up to from zero
+        if (delaySmoother.getCurrentValue() < (SampleType)minimumDelay)
+        {
+            delaySmoother.setCurrentAndTargetValue(delayInSamples);
+            return;
+        }
+
+        if (delayInSamples == delaySmoother.getTargetValue())
+            return;
+
+        // SmoothedValue::reset() snaps to the target, so carry the current delay across
+        if (rampLengthInSamples != rampLength)
+        {
+            const auto current = delaySmoother.getCurrentValue();
+            rampLength = rampLengthInSamples;
+            delaySmoother.reset(rampLength);
+            delaySmoother.setCurrentAndTargetValue(current);
+        }
+
+        delaySmoother.setTargetValue(delayInSamples);
+    }
+
+    SampleType getMaxDelay() const noexcept { return (SampleType)(mask - 3); }
+    bool isSmoothing() const noexcept { return delaySmoother.isSmoothing(); }
+    SampleType getNextDelay() noexcept { return delaySmoother.getNextValue(); }
+    SampleType getCurrentDelay() const noexcept { return delaySmoother.getCurrentValue(); }
+
+    // Integer-delay read, no interpolation
+    SampleType readInteger(int delayInSamples) const noexcept
+    {
+        return ring[(writeIndex - delayInSamples) & mask];
+    }
+
+    template <Interpolation mode>
+    SampleType read(SampleType delayInSamples) noexcept
+    {
+        return read<mode>(delayInSamples, allpassState);
+    }
+
+    // Extra taps pass their own allpass state; it's ignored for linear and lagrange
+    template <Interpolation mode>
+    SampleType read(SampleType delayInSamples, SampleType& tapState) const noexcept
+    {
+        auto delayInt = (int)delayInSamples;
+        auto frac = delayInSamples - (SampleType)delayInt;
+
+        if constexpr (mode == Interpolation::linear)
+        {
+            juce::ignoreUnused(tapState);
+            const auto a = readInteger(delayInt);
+            const auto b = readInteger(delayInt + 1);
+            return a + frac * (b - a);
+        }
+        else if constexpr (mode == Interpolation::lagrange)
+        {
+            juce::ignoreUnused(tapState);
+
+            // Centre the four taps on the read point: frac moves into [1, 2)
+            --delayInt;
+            frac += 1;
+
+            const auto x0 = readInteger(delayInt);
+            const auto x1 = readInteger(delayInt + 1);
+            const auto x2 = readInteger(delayInt + 2);
+            const auto x3 = readInteger(delayInt + 3);
+
+            const auto d1 = frac - 1, d2 = frac - 2, d3 = frac - 3;
+            const auto c0 = -d1 * d2 * d3 / 6;
+            const auto c1 = d2 * d3 / 2;
+            const auto c2 = -d1 * d3 / 2;
+            const auto c3 = d1 * d2 / 6;
+
+            return x0 * c0 + frac * (x1 * c1 + x2 * c2 + x3 * c3);
+        }
+        else
+        {
+            // Keep the allpass fraction away from 0, where its pole sits on the unit circle
+            if (frac < (SampleType)0.618)
+            {
+                --delayInt;
+                frac += 1;
+            }
+
+            const auto alpha = (1 - frac) / (1 + frac);
+            tapState = readInteger(delayInt + 1) + alpha * (readInteger(delayInt) - tapState);
+            return tapState;
+        }
+    }
+
+    void write(SampleType sample) noexcept
+    {
+        ring[writeIndex] = sample;
+        writeIndex = (writeIndex + 1) & mask;
+    }
+
+    // How many samples, up to maxSamples, can go through readBlock() and the
+    // write pointer at the current delay. Zero or less means fall back to read()
+    // for one sample, which happens for a few samples per trip round the ring.
+    int getContiguousRun(int maxSamples) const noexcept
+    {
+        const auto delayInt = (int)getCurrentDelay();
+        const auto size = mask + 1;
+
+        return juce::jmin(maxSamples,
+                          delayInt - 2,                                 // reads stay behind this run's writes
+                          size - writeIndex,                            // write head doesn't wrap
+                          size - 3 - getOldestTapIndex(delayInt));      // newest tap doesn't wrap
+    }
+
+    // Reads numSamples consecutive outputs at the current, settled delay.
+    // numSamples must not exceed getContiguousRun().
+    template <Interpolation mode>
+    void readBlock(SampleType* destination, int numSamples) noexcept
+    {
+        jassert(! isSmoothing() && numSamples <= getContiguousRun(numSamples));
+
+        const auto delay = getCurrentDelay();
+        const auto delayInt = (int)delay;
+        const auto frac = delay - (SampleType)delayInt;
+
+        // Taps as pointers, so each one is a plain walk through memory. The
+        // interpolators with fixed weights are sums of scaled taps, which
+        // FloatVectorOperations does with SIMD whatever the optimiser settings.
+        const auto* oldest = ring + getOldestTapIndex(delayInt);
+        const auto tap = [&](int delayInSamples) { return oldest + (delayInt + 2 - delayInSamples); };
+
+        using FVO = juce::FloatVectorOperations;
+
+        if constexpr (mode == Interpolation::linear)
+        {
+            FVO::multiply(destination, tap(delayInt), 1 - frac, numSamples);
+            FVO::addWithMultiply(destination, tap(delayInt + 1), frac, numSamples);
+        }
+        else if constexpr (mode == Interpolation::lagrange)
+        {
+            // Same weights as read(), computed once for the run
+            const auto t = frac + 1;
+            const auto d1 = t - 1, d2 = t - 2, d3 = t - 3;
+            const auto c0 = -d1 * d2 * d3 / 6;
+            const auto c1 = t * d2 * d3 / 2;
+            const auto c2 = -t * d1 * d3 / 2;
+            const auto c3 = t * d1 * d2 / 6;
+
+            FVO::multiply(destination, tap(delayInt - 1), c0, numSamples);
+            FVO::addWithMultiply(destination, tap(delayInt), c1, numSamples);
+            FVO::addWithMultiply(destination, tap(delayInt + 1), c2, numSamples);
+            FVO::addWithMultiply(destination, tap(delayInt + 2), c3, numSamples);
+        }
+        else
+        {
+            auto allpassDelay = delayInt;
+            auto allpassFrac = frac;
+
+            if (allpassFrac < (SampleType)0.618)
+            {
+                --allpassDelay;
+                allpassFrac += 1;
+            }
+
+            const auto alpha = (1 - allpassFrac) / (1 + allpassFrac);
+            const auto* newer = tap(allpassDelay);
+            const auto* older = tap(allpassDelay + 1);
+            auto state = allpassState;
+
+            // Recursive, so this one stays scalar, but still without wrapping
+            for (int i = 0; i < numSamples; ++i)
+            {
+                state = older[i] + alpha * (newer[i] - state);
+                destination[i] = state;
+            }
+
+            allpassState = state;
+        }
+    }
+
+    // Fill up to getContiguousRun() samples here, then commit them with advanceWrite()
+    SampleType* getWritePointer() noexcept { return ring + writeIndex; }
+    void advanceWrite(int numSamples) noexcept { writeIndex = (writeIndex + numSamples) & mask; }
+
+private:
+    // Ring index of the oldest sample any interpolator touches at this integer delay
+    int getOldestTapIndex(int delayInt) const noexcept
+    {
+        return (writeIndex - delayInt - 2) & mask;
+    }
+
+    SampleType* ring = nullptr;
+    int mask = 0;
+    int writeIndex = 0;
+    SampleType allpassState = 0;
+    int glideLength = 0, rampLength = 0;
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> delaySmoother;
+};
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include "ImpulseResponse.h"
+
+namespace
+{
+    // Trailing samples below this (relative to the peak) are trimmed off the end
+    constexpr float silenceThreshold = 1.0e-5f;
+
+    int findEnd(const juce::AudioBuffer<float>& buffer)
+    {
+        const auto threshold = buffer.getMagnitude(0, buffer.getNumSamples()) * silenceThreshold;
+
+        for (int end = buffer.getNumSamples(); end > 0; --end)
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                if (std::abs(buffer.getSample(channel, end - 1)) > threshold)
+                    return end;
+
+        return 0;
+    }
+}
+
+ImpulseResponse::ImpulseResponse(const juce::AudioBuffer<float>& source, double sampleRate, const juce::String& name)
+    : numChannels(juce::jlimit(1, 2, source.getNumChannels())),
+      rate(sampleRate),
+      irName(name)
+{
+    length = juce::jmax(1, juce::jmin(findEnd(source), (int)(maxSeconds * sampleRate)));
+
+    // Unit energy on the louder channel, so swapping between IRs doesn't jump the level
+    double energy = 0.0;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        double channelEnergy = 0.0;
+
+        for (int i = 0; i < juce::jmin(length, source.getNumSamples()); ++i)
+            channelEnergy += (double)source.getSample(channel, i) * source.getSample(channel, i);
+
+        energy = juce::jmax(energy, channelEnergy);
+    }
+
+    const auto gain = energy > 0.0 ? (float)(1.0 / std::sqrt(energy)) : 0.0f;
+
+    juce::AudioBuffer<float> taps(numChannels, length);
+    taps.clear();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        taps.copyFrom(channel, 0, source, channel, 0, juce::jmin(length, source.getNumSamples()), gain);
+
+    // Short IRs go entirely through the FIR; long ones only their first partition's worth
+    directLength = length <= maxDirectLength ? length : partitionSize;
+    numPartitions = (length - directLength + partitionSize - 1) / partitionSize;
+
+    direct.setSize(numChannels, directLength);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        direct.copyFrom(channel, 0, taps, channel, 0, directLength);
+
+    spectra.assign((size_t)(numChannels * numPartitions * numBins * 2), 0.0f);
+
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> fftData((size_t)fftSize * 2);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int partition = 0; partition < numPartitions; ++partition)
+        {
+            // partitionSize taps followed by as many zeros, for overlap-save
+            const auto start = directLength + partition * partitionSize;
+            const auto count = juce::jmin(partitionSize, length - start);
+
+            std::fill(fftData.begin(), fftData.end(), 0.0f);
+            std::copy_n(taps.getReadPointer(channel, start), count, fftData.begin());
+            fft.performRealOnlyForwardTransform(fftData.data(), true);
+
+            auto* real = spectra.data() + getPartitionOffset(channel, partition);
+            auto* imag = real + numBins;
+
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                real[bin] = fftData[(size_t)bin * 2];
+                imag[bin] = fftData[(size_t)bin * 2 + 1];
+            }
+        }
+    }
+
+    // Overview for the editor: peak of each slice, scaled to the loudest
+    const auto sliceLength = juce::jmax(1, (length + overviewSize - 1) / overviewSize);
+
+    for (int slice = 0; slice < overviewSize; ++slice)
+    {
+        const auto start = slice * sliceLength;
+
+        if (start < length)
+            overview[(size_t)slice] = taps.getMagnitude(start, juce::jmin(sliceLength, length - start));
+    }
+
+    const auto overviewPeak = *std::max_element(overview.begin(), overview.end());
+
+    if (overviewPeak > 0.0f)
+        for (auto& value : overview)
+            value /= overviewPeak;
+}
+
+size_t ImpulseResponse::getPartitionOffset(int channel, int partition) const noexcept
+{
+    return (size_t)(channel * numPartitions + partition) * numBins * 2;
+}
+
+const float* ImpulseResponse::getPartitionReal(int channel, int partition) const noexcept
+{
+    return spectra.data() + getPartitionOffset(channel, partition);
+}
+
+const float* ImpulseResponse::getPartitionImag(int channel, int partition) const noexcept
+{
+    return getPartitionReal(channel, partition) + numBins;
+}
+
+ImpulseResponseLibrary::ImpulseResponseLibrary()
+{
+    formatManager.registerBasicFormats();
+}
+
+ImpulseResponseLibrary::~ImpulseResponseLibrary()
+{
+    loader.removeAllJobs(true, 5000);
+}
+
+std::shared_ptr<const ImpulseResponse> ImpulseResponseLibrary::get(const juce::File& file, double sampleRate, juce::String& error)
+{
+    if (! file.existsAsFile())
+    {
+        error = "File not found";
+        return {};
+    }
+
+    // Same bytes at the same rate means the same prepared IR, whatever the file is called
+    const auto key = juce::MD5(file).toHexString() + "@" + juce::String(sampleRate);
+
+    {
+        const juce::ScopedLock lock(cacheLock);
+
+        if (auto existing = cache[key].lock())
+            return existing;
+    }
+
+    auto response = decode(file, sampleRate, error);
+
+    if (response != nullptr)
+    {
+        const juce::ScopedLock lock(cacheLock);
+
+        // Drop the entries nobody holds any more while we're here
+        for (auto it = cache.begin(); it != cache.end();)
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+
+        cache[key] = response;
+    }
+
+    return response;
+}
+
+std::shared_ptr<const ImpulseResponse> ImpulseResponseLibrary::decode(const juce::File& file, double sampleRate, juce::String& error)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr)
+    {
+        error = "Unsupported audio file";
+        return {};
+    }
+
+    const auto numChannels = juce::jlimit(1, 2, (int)reader->numChannels);
+    const auto ratio = reader->sampleRate / sampleRate;
+    const auto maxSourceLength = (juce::int64)(ImpulseResponse::maxSeconds * reader->sampleRate);
+    const auto sourceLength = (int)juce::jmin(reader->lengthInSamples, maxSourceLength);
+
+    if (sourceLength <= 0)
+    {
+        error = "Empty audio file";
+        return {};
+    }
+
+    juce::AudioBuffer<float> source(numChannels, sourceLength);
+    reader->read(&source, 0, sourceLength, 0, true, numChannels > 1);
+
+    if (ratio == 1.0)
+        return std::make_shared<ImpulseResponse>(source, sampleRate, file.getFileNameWithoutExtension());
+
+    // ResamplingAudioSource band-limits when going down in rate, so a 96 kHz
+    // IR played at 44.1 kHz doesn't fold its top octave back down
+    const auto resampledLength = (int)std::ceil(sourceLength / ratio);
+    juce::AudioBuffer<float> resampled(numChannels, resampledLength);
+
+    juce::MemoryAudioSource memorySource(source, false);
+    juce::ResamplingAudioSource resampler(&memorySource, false, numChannels);
+    resampler.setResamplingRatio(ratio);
+    resampler.prepareToPlay(resampledLength, sampleRate);
+    resampler.getNextAudioBlock(juce::AudioSourceChannelInfo(resampled));
+    resampler.releaseResources();
+
+    return std::make_shared<ImpulseResponse>(resampled, sampleRate, file.getFileNameWithoutExtension());
+}
\ No newline at end of file
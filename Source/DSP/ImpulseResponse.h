@@ -0,0 +1,99 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// An impulse response prepared for ConvolutionStage, at one sample rate.
+//
+// Built once off the audio thread and never changed afterwards, so any number
+// of engines can read it at the same time. The first taps are kept as they
+// are for the direct-form FIR. Everything after them is cut into
+// partitionSize-long pieces, each zero-padded and transformed, ready for
+// uniformly partitioned overlap-save convolution. IRs up to maxDirectLength
+// taps are all direct and have no partitions.
+//
+// Spectra are stored split (all real parts, then all imaginary parts) so the
+// complex multiply-accumulate runs as plain vectorisable loops.
+class ImpulseResponse
+{
+public:
+    static constexpr int maxDirectLength = 512;
+    static constexpr int partitionSize = 256;
+    static constexpr int fftOrder = 9;                     // 2 * partitionSize
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = partitionSize + 1;      // non-negative frequencies of fftSize
+    static constexpr double maxSeconds = 10.0;
+    static constexpr int overviewSize = 256;
+
+    // Normalises, partitions and transforms an IR already at the target rate
+    ImpulseResponse(const juce::AudioBuffer<float>& source, double sampleRate, const juce::String& name);
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getLength() const noexcept { return length; }
+    double getSampleRate() const noexcept { return rate; }
+    const juce::String& getName() const noexcept { return irName; }
+
+    // Direct-form taps of a channel, in time order
+    int getDirectLength() const noexcept { return directLength; }
+    const float* getDirectTaps(int channel) const noexcept { return direct.getReadPointer(channel); }
+
+    // Spectrum of partition p, covering taps directLength + p * partitionSize onwards
+    int getNumPartitions() const noexcept { return numPartitions; }
+    const float* getPartitionReal(int channel, int partition) const noexcept;
+    const float* getPartitionImag(int channel, int partition) const noexcept;
+
+    // Peak level over overviewSize equal slices of the IR, 0..1, for the editor
+    const std::array<float, overviewSize>& getOverview() const noexcept { return overview; }
+
+private:
+    size_t getPartitionOffset(int channel, int partition) const noexcept;
+
+    int numChannels = 0;
+    int length = 0;
+    int directLength = 0;
+    int numPartitions = 0;
+    double rate = 44100.0;
+    juce::String irName;
+
+    juce::AudioBuffer<float> direct;
+    std::vector<float> spectra;   // [channel][partition][real bins, imag bins]
+    std::array<float, overviewSize> overview {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImpulseResponse)
+};
+
+// Process-wide store of prepared impulse responses, shared by every plugin
+// instance through juce::SharedResourcePointer.
+//
+// Responses are keyed by the file's content hash and the target sample rate,
+// and held weakly: thirty instances loading the same cab share one copy, and
+// it's freed when the last of them lets go. Decoding, resampling and
+// partitioning happen on the library's single loader thread, which also runs
+// each caller's job so loads of the same file queue up behind one another and
+// the second finds the first's result.
+class ImpulseResponseLibrary
+{
+public:
+    ImpulseResponseLibrary();
+    ~ImpulseResponseLibrary();
+
+    // The prepared response for a file at a sample rate, decoding it if no
+    // instance has it already. Call on the loader thread; empty with an error
+    // message if the file can't be read.
+    std::shared_ptr<const ImpulseResponse> get(const juce::File& file, double sampleRate, juce::String& error);
+
+    juce::ThreadPool& getLoaderThread() noexcept { return loader; }
+
+private:
+    std::shared_ptr<const ImpulseResponse> decode(const juce::File& file, double sampleRate, juce::String& error);
+
+    juce::AudioFormatManager formatManager;
+
+    juce::CriticalSection cacheLock;
+    std::map<juce::String, std::weak_ptr<const ImpulseResponse>> cache;
+
+    juce::ThreadPool loader { juce::ThreadPoolOptions {}.withThreadName("IR loader")
+                                                     .withNumberOfThreads(1)
+                                                     .withDesiredThreadPriority(juce::Thread::Priority::low) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImpulseResponseLibrary)
+};
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// The register the lane-parallel stages (ModulationStage, FdnReverb) are
+// written against.
+//
+// With JUCE_USE_SIMD this is juce::dsp::SIMDRegister, as wide as the target
+// builds it: 4 floats on SSE and NEON, 8 once AVX is enabled. Without it JUCE
+// leaves SIMDRegister out entirely, so a one-lane register with the few
+// operations the stages use stands in, and the same loops run scalar.
+#if JUCE_USE_SIMD
+template <typename SampleType>
+using LaneRegister = juce::dsp::SIMDRegister<SampleType>;
+#else
+template <typename SampleType>
+struct LaneRegister
+{
+    static constexpr size_t SIMDNumElements = 1;
+    static constexpr size_t SIMDRegisterSize = sizeof(SampleType);
+
+    SampleType value;
+
+    static LaneRegister expand(SampleType x) noexcept { return { x }; }
+    static LaneRegister fromRawArray(const SampleType* source) noexcept { return { *source }; }
+    void copyToRawArray(SampleType* dest) const noexcept { *dest = value; }
+    SampleType sum() const noexcept { return value; }
+
+    LaneRegister operator+ (LaneRegister other) const noexcept { return { value + other.value }; }
+    LaneRegister operator- (LaneRegister other) const noexcept { return { value - other.value }; }
+    LaneRegister operator* (LaneRegister other) const noexcept { return { value * other.value }; }
+    LaneRegister& operator+= (LaneRegister other) noexcept { value += other.value; return *this; }
+    LaneRegister& operator-= (LaneRegister other) noexcept { value -= other.value; return *this; }
+    LaneRegister& operator*= (LaneRegister other) noexcept { value *= other.value; return *this; }
+};
+#endif
\ No newline at end of file
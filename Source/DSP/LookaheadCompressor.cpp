@@ -0,0 +1,225 @@
+#include "LookaheadCompressor.h"
+
+namespace
+{
+    constexpr double makeupRampSeconds = 0.05;
+
+    // Levels below this are treated as silence by the gain computer
+    constexpr float floorDb = -120.0f;
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    currentSampleRate = spec.sampleRate;
+    maxLookaheadSamples = (int)std::ceil(maxLookaheadSeconds * spec.sampleRate);
+
+    // The ring holds the longest look-ahead plus one sample, for the write that
+    // happens before the read at zero look-ahead. It waits for setStorage(); the
+    // old storage may be gone.
+    numChannels = (int)spec.numChannels;
+    mask = juce::nextPowerOfTwo(maxLookaheadSamples + 1) - 1;
+    rings = nullptr;
+
+    // The window spans the look-ahead and the sample being written
+    peakWindow.prepare(maxLookaheadSamples + 1);
+
+    makeupDb.reset(spec.sampleRate, makeupRampSeconds);
+
+    attackCoefficient = getCoefficient(attackMs, controlInterval, currentSampleRate);
+    releaseCoefficient = getCoefficient(releaseMs, controlInterval, currentSampleRate);
+
+    reset();
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::setStorage(SampleType* storage) noexcept
+{
+    rings = storage;
+    writeIndex = 0;
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::reset() noexcept
+{
+    clear();
+    snapToTargets = true;
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::clear() noexcept
+{
+    if (rings != nullptr)
+        std::fill(rings, rings + getRequiredStorage(), SampleType());
+
+    writeIndex = 0;
+    peakWindow.reset();
+    reductionDb = 0.0f;
+    currentGain = juce::Decibels::decibelsToGain(makeupDb.getTargetValue());
+    makeupDb.setCurrentAndTargetValue(makeupDb.getTargetValue());
+    gainReductionMeter.store(0.0f, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::setParameters(bool shouldBeEnabled, float newThresholdDb, float newRatio, float newAttackMs,
+                                                    float newReleaseMs, float newLookaheadMs, float newMakeupDb) noexcept
+{
+    const bool switchedOn = shouldBeEnabled && ! enabled;
+    enabled = shouldBeEnabled;
+
+    thresholdDb = newThresholdDb;
+    ratio = juce::jmax(1.0f, newRatio);
+
+    if (newAttackMs != attackMs)
+    {
+        attackMs = newAttackMs;
+        attackCoefficient = getCoefficient(attackMs, controlInterval, currentSampleRate);
+    }
+
+    if (newReleaseMs != releaseMs)
+    {
+        releaseMs = newReleaseMs;
+        releaseCoefficient = getCoefficient(releaseMs, controlInterval, currentSampleRate);
+    }
+
+    lookaheadSamples = juce::jlimit(0, maxLookaheadSamples, juce::roundToInt(newLookaheadMs * 0.001 * currentSampleRate));
+    peakWindow.setWindowLength(lookaheadSamples + 1);
+
+    if (snapToTargets)
+    {
+        makeupDb.setCurrentAndTargetValue(newMakeupDb);
+        currentGain = juce::Decibels::decibelsToGain(newMakeupDb);
+        snapToTargets = false;
+    }
+    else
+    {
+        makeupDb.setTargetValue(newMakeupDb);
+    }
+
+    // Whatever was in the delay when it was last switched off is long stale
+    if (switchedOn)
+        clear();
+}
+
+template <typename SampleType>
+int LookaheadCompressor<SampleType>::getLatencySamples(bool shouldBeEnabled, float lookaheadMs, double sampleRate) noexcept
+{
+    if (! shouldBeEnabled)
+        return 0;
+
+    const auto maxSamples = (int)std::ceil(maxLookaheadSeconds * sampleRate);
+    return juce::jlimit(0, maxSamples, juce::roundToInt(lookaheadMs * 0.001 * sampleRate));
+}
+
+template <typename SampleType>
+float LookaheadCompressor<SampleType>::computeGainReduction(float levelDb, float thresholdDb, float ratio) noexcept
+{
+    const auto slope = ratio >= limiterRatio ? 1.0f : 1.0f - 1.0f / ratio;
+    const auto over = levelDb - thresholdDb;
+
+    if (over <= -0.5f * kneeDb)
+        return 0.0f;
+
+    if (over >= 0.5f * kneeDb)
+        return slope * over;
+
+    // Quadratic through the knee, meeting both straight parts with matching slope
+    const auto intoKnee = over + 0.5f * kneeDb;
+    return slope * intoKnee * intoKnee / (2.0f * kneeDb);
+}
+
+template <typename SampleType>
+float LookaheadCompressor<SampleType>::getCoefficient(float milliseconds, int numSamples, double sampleRate) noexcept
+{
+    // One-pole step over numSamples: reaches 1 - 1/e of a jump in the given time
+    return (float)std::exp(-numSamples / (juce::jmax(0.01, (double)milliseconds) * 0.001 * sampleRate));
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto channelsToProcess = juce::jmin((int)block.getNumChannels(), numChannels);
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (! enabled || rings == nullptr || channelsToProcess == 0 || numSamples == 0)
+        return;
+
+    float peaks[controlInterval];
+    float gains[controlInterval];
+
+    for (int start = 0; start < numSamples; start += controlInterval)
+    {
+        const auto count = juce::jmin(controlInterval, numSamples - start);
+
+        // Detector input: the loudest channel at each sample
+        const auto* first = block.getChannelPointer(0) + start;
+
+        for (int i = 0; i < count; ++i)
+            peaks[i] = (float)std::abs(first[i]);
+
+        for (int channel = 1; channel < channelsToProcess; ++channel)
+        {
+            const auto* input = block.getChannelPointer((size_t)channel) + start;
+
+            for (int i = 0; i < count; ++i)
+                peaks[i] = juce::jmax(peaks[i], (float)std::abs(input[i]));
+        }
+
+        // The loudest sample any output in this interval will see inside its look-ahead
+        float intervalPeak = 0.0f;
+
+        for (int i = 0; i < count; ++i)
+            intervalPeak = juce::jmax(intervalPeak, peakWindow.push(peaks[i]));
+
+        // Gain computer and ballistics, in dB, once per interval
+        const auto targetDb = computeGainReduction(juce::Decibels::gainToDecibels(intervalPeak, floorDb), thresholdDb, ratio);
+        auto coefficient = targetDb > reductionDb ? attackCoefficient : releaseCoefficient;
+
+        if (count != controlInterval)
+            coefficient = std::pow(coefficient, (float)count / (float)controlInterval);
+
+        reductionDb = targetDb + coefficient * (reductionDb - targetDb);
+
+        const auto nextGain = juce::Decibels::decibelsToGain(makeupDb.skip(count) - reductionDb);
+        const auto step = (nextGain - currentGain) / (float)count;
+
+        for (int i = 0; i < count; ++i)
+            gains[i] = currentGain + step * (float)(i + 1);
+
+        currentGain = nextGain;
+
+        // Delay each channel by the look-ahead and apply the ramp
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            auto* data = block.getChannelPointer((size_t)channel) + start;
+            auto* ring = rings + channel * (mask + 1);
+
+            for (int i = 0; i < count; ++i)
+            {
+                const auto index = writeIndex + i;
+                ring[index & mask] = data[i];
+                data[i] = ring[(index - lookaheadSamples) & mask] * (SampleType)gains[i];
+            }
+        }
+
+        writeIndex = (writeIndex + count) & mask;
+    }
+
+    gainReductionMeter.store(reductionDb, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void LookaheadCompressor<SampleType>::skipSilence(int numSamples) noexcept
+{
+    if (! enabled || numSamples <= 0)
+        return;
+
+    // Silence is under any threshold, so the reduction releases towards zero
+    reductionDb *= std::pow(releaseCoefficient, (float)numSamples / (float)controlInterval);
+    currentGain = juce::Decibels::decibelsToGain(makeupDb.skip(numSamples) - reductionDb);
+
+    gainReductionMeter.store(reductionDb, std::memory_order_relaxed);
+}
+
+template class LookaheadCompressor<float>;
+template class LookaheadCompressor<double>;
\ No newline at end of file
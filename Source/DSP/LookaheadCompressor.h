@@ -0,0 +1,98 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SlidingMaximum.h"
+
+// Feed-forward peak compressor and limiter with look-ahead.
+//
+// The audio is delayed by the look-ahead while the detector sees it straight
+// away, so gain reduction is already in place when a peak comes out. The
+// detector is a sliding maximum over the look-ahead window of the channels'
+// peak level (one gain for all channels, keeping the stereo image). It runs in
+// O(1) per sample whatever the look-ahead.
+//
+// Gain is worked out in dB once per controlInterval samples: the window peak
+// goes through a soft-knee curve, then attack/release smoothing. Only the
+// result goes back to linear, and it's ramped per sample to the next value,
+// so the per-sample path is just the delay and a multiply. Ratios of
+// limiterRatio and up hold the output at the threshold.
+//
+// The latency is the look-ahead while enabled and zero while bypassed.
+//
+// The audio path runs in SampleType; the detector and gain computer stay in
+// float, which is far finer than any gain change they make.
+template <typename SampleType>
+class LookaheadCompressor
+{
+public:
+    static constexpr double maxLookaheadSeconds = 0.01;
+    static constexpr int controlInterval = 16;      // samples per gain computation
+    static constexpr float kneeDb = 6.0f;
+    static constexpr float limiterRatio = 20.0f;
+
+    LookaheadCompressor() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    // Samples of storage the look-ahead delay needs after prepare(). setStorage()
+    // takes it zeroed, or nullptr to let go of it; process() does nothing without any.
+    int getRequiredStorage() const noexcept { return numChannels * (mask + 1); }
+    void setStorage(SampleType* storage) noexcept;
+    bool hasStorage() const noexcept { return rings != nullptr; }
+
+    // Threshold and makeup in dB, attack, release and look-ahead in ms.
+    // Switching on clears the look-ahead delay, so no stale audio comes out.
+    void setParameters(bool enabled, float thresholdDb, float ratio, float attackMs, float releaseMs,
+                       float lookaheadMs, float makeupDb) noexcept;
+
+    // Compresses the block in place. Does nothing while disabled.
+    void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // Moves the gain on as numSamples of silence would, for blocks the caller
+    // skips once the look-ahead delay holds nothing but silence
+    void skipSilence(int numSamples) noexcept;
+
+    bool isEnabled() const noexcept { return enabled; }
+    int getLatencySamples() const noexcept { return enabled ? lookaheadSamples : 0; }
+
+    // The latency the given settings will have once they reach the stage, so
+    // the message thread can tell the host without waiting for the audio thread
+    static int getLatencySamples(bool shouldBeEnabled, float lookaheadMs, double sampleRate) noexcept;
+
+    // Gain reduction in dB (0 or more) at the end of the last block, for the editor
+    float getGainReductionDb() const noexcept { return gainReductionMeter.load(std::memory_order_relaxed); }
+
+    // The static curve: dB of reduction for a level in dB. The editor draws it.
+    static float computeGainReduction(float levelDb, float thresholdDb, float ratio) noexcept;
+
+private:
+    void clear() noexcept;
+    static float getCoefficient(float milliseconds, int numSamples, double sampleRate) noexcept;
+
+    // One look-ahead ring per channel, side by side in the storage
+    SampleType* rings = nullptr;
+    int numChannels = 0;
+    int mask = 0;
+    int writeIndex = 0;
+    int lookaheadSamples = 0;
+    int maxLookaheadSamples = 0;
+    double currentSampleRate = 44100.0;
+
+    SlidingMaximum<float> peakWindow;
+
+    float thresholdDb = 0.0f;
+    float ratio = 1.0f;
+    float attackMs = 5.0f, releaseMs = 100.0f;
+    float attackCoefficient = 0.0f, releaseCoefficient = 0.0f;   // per full control interval
+    juce::SmoothedValue<float> makeupDb;
+
+    float reductionDb = 0.0f;   // smoothed, at the last control point
+    float currentGain = 1.0f;   // linear, where the per-sample ramp got to
+    bool enabled = false;
+    bool snapToTargets = true;  // the first settings after reset() apply without a ramp
+
+    std::atomic<float> gainReductionMeter { 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LookaheadCompressor)
+};
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include "ModulationStage.h"
+
+namespace
+{
+    // Voice delays swing around the centre by up to the swing, in milliseconds
+    constexpr float chorusCentreMs = 20.0f;
+    constexpr float chorusSwingMs = 12.0f;
+    constexpr float flangerCentreMs = 3.0f;
+    constexpr float flangerSwingMs = 2.8f;
+
+    // The phaser sweeps its break frequency up to three octaves either side of the centre
+    constexpr float phaserCentreFrequency = 800.0f;
+    constexpr float phaserMaxOctaves = 3.0f;
+
+    // Room for the longest chorus delay; the ring adds the interpolator's taps
+    constexpr double maxDelaySeconds = (chorusCentreMs + chorusSwingMs) * 0.001 + 0.001;
+
+    constexpr double feedbackRampSeconds = 0.05;
+    constexpr double mixRampSeconds = 0.05;
+    constexpr double modeFadeSeconds = 0.02;    // each way, around the clear on a mode change
+
+    // LFO phase of each voice, in cycles. A channel's two chorus voices move in
+    // opposite directions; the flanger and phaser give each channel one sweep,
+    // with right a quarter cycle behind left.
+    constexpr float voicePhases[3][ModulationStage<float>::numVoices] = { { 0.0f, 0.5f, 0.25f, 0.75f },
+                                                                   { 0.0f, 0.0f, 0.25f, 0.25f },
+                                                                   { 0.0f, 0.0f, 0.25f, 0.25f } };
+
+    double getStepAngle(float rateHz, int numSamples, double sampleRate)
+    {
+        return juce::MathConstants<double>::twoPi * rateHz * numSamples / sampleRate;
+    }
+}
+
+template <typename SampleType>
+typename ModulationStage<SampleType>::Vector ModulationStage<SampleType>::load(const SampleType* source) noexcept
+{
+    Vector result;
+
+    for (int r = 0; r < numRegisters; ++r)
+        result[(size_t)r] = Register::fromRawArray(source + r * lanes);
+
+    return result;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::store(const Vector& source, SampleType* destination) noexcept
+{
+    for (int r = 0; r < numRegisters; ++r)
+        source[(size_t)r].copyToRawArray(destination + r * lanes);
+}
+
+template <typename SampleType>
+float ModulationStage<SampleType>::getDelayMilliseconds(Mode mode, float depth, float lfo) noexcept
+{
+    if (mode == Mode::flanger)
+        return flangerCentreMs + flangerSwingMs * depth * lfo;
+
+    return chorusCentreMs + chorusSwingMs * depth * lfo;
+}
+
+template <typename SampleType>
+float ModulationStage<SampleType>::getPhaserFrequency(float depth, float lfo) noexcept
+{
+    return phaserCentreFrequency * std::exp2(phaserMaxOctaves * depth * lfo);
+}
+
+template <typename SampleType>
+float ModulationStage<SampleType>::getVoicePhase(Mode mode, int voice) noexcept
+{
+    return voicePhases[(int)mode][voice];
+}
+
+template <typename SampleType>
+double ModulationStage<SampleType>::getTailSeconds(Mode mode, float depth, float feedback, float floorDb) noexcept
+{
+    // One pass through the voices: the longest ring, or for the phaser the
+    // allpass cascade, each section's impulse response falling by a factor of e
+    // every 1 / (2 pi f) seconds at its lowest break frequency
+    auto passSeconds = maxDelaySeconds;
+
+    if (mode == Mode::phaser)
+    {
+        const auto timeConstants = -floorDb / juce::Decibels::gainToDecibels(juce::MathConstants<float>::euler);
+        passSeconds = numPhaserStages * timeConstants / (juce::MathConstants<double>::twoPi * getPhaserFrequency(depth, -1.0f));
+    }
+
+    // Feedback sends it round again, a little quieter each time
+    const auto feedbackDb = juce::Decibels::gainToDecibels(std::abs(feedback), floorDb);
+    const auto passes = feedbackDb > floorDb ? 1.0 + std::ceil(floorDb / juce::jmin(feedbackDb, -0.01f)) : 1.0;
+
+    return passSeconds * passes;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    currentSampleRate = spec.sampleRate;
+
+    // A few milliseconds of ring per channel, sharing one block of storage like
+    // the delay's. The rings wait for setStorage(); the old storage may be gone.
+    const auto numChannels = juce::jlimit(1, 2, (int)spec.numChannels);
+    ringLength = FractionalDelayLine<SampleType>::getRequiredStorage((int)std::ceil(maxDelaySeconds * spec.sampleRate));
+    lines.resize((size_t)numChannels);
+    setStorage(nullptr);
+
+    // Voices 0 and 1 on the left, 2 and 3 on the right; all on the one channel of a mono bus
+    for (int voice = 0; voice < numVoices; ++voice)
+        voiceChannels[voice] = numChannels > 1 ? voice * 2 / numVoices : 0;
+
+    const auto angle = getStepAngle(rate, controlInterval, currentSampleRate);
+    stepCos = (float)std::cos(angle);
+    stepSin = (float)std::sin(angle);
+
+    feedback.reset(spec.sampleRate, feedbackRampSeconds);
+    mix.reset(spec.sampleRate, mixRampSeconds);
+    modeFade.reset(spec.sampleRate, modeFadeSeconds);
+
+    reset();
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::setStorage(SampleType* storage) noexcept
+{
+    for (size_t channel = 0; channel < lines.size(); ++channel)
+        lines[channel].setStorage(storage != nullptr ? storage + channel * (size_t)ringLength : nullptr, ringLength);
+
+    hasRings = storage != nullptr;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::reset() noexcept
+{
+    mode = pendingMode;
+    modeFade.setCurrentAndTargetValue(1.0f);
+    clear();
+    snapToTargets = true;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::clear() noexcept
+{
+    for (auto& line : lines)
+        line.reset();
+
+    allpassStates = {};
+    phaserOutput = {};
+    resetLfo();
+    snapModulation = true;
+    needsClear = false;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::resetLfo() noexcept
+{
+    alignas(Register::SIMDRegisterSize) SampleType cosines[numLanes] {};
+    alignas(Register::SIMDRegisterSize) SampleType sines[numLanes] {};
+
+    for (int voice = 0; voice < numVoices; ++voice)
+    {
+        const auto phase = juce::MathConstants<float>::twoPi * getVoicePhase(mode, voice);
+        cosines[voice] = std::cos(phase);
+        sines[voice] = std::sin(phase);
+    }
+
+    lfoCos = load(cosines);
+    lfoSin = load(sines);
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::setParameters(int newMode, float newRate, float newDepth, float newFeedback, float newMix) noexcept
+{
+    const auto clampedMode = (Mode)juce::jlimit(0, 2, newMode);
+
+    // The voices mean something else in the new mode, so it starts from
+    // silence. While the wet signal can be heard it fades out first; process()
+    // clears and switches once it is down, then fades the new mode back in.
+    if (clampedMode != pendingMode)
+    {
+        pendingMode = clampedMode;
+
+        if (snapToTargets || ! isActive())
+            needsClear = true;
+        else
+            modeFade.setTargetValue(pendingMode == mode ? 1.0f : 0.0f);
+    }
+
+    if (newRate != rate)
+    {
+        rate = newRate;
+
+        const auto angle = getStepAngle(rate, controlInterval, currentSampleRate);
+        stepCos = (float)std::cos(angle);
+        stepSin = (float)std::sin(angle);
+    }
+
+    depth = juce::jlimit(0.0f, 1.0f, newDepth);
+
+    if (snapToTargets)
+    {
+        feedback.setCurrentAndTargetValue(newFeedback);
+        mix.setCurrentAndTargetValue(newMix);
+        snapToTargets = false;
+    }
+    else
+    {
+        feedback.setTargetValue(newFeedback);
+        mix.setTargetValue(newMix);
+    }
+}
+
+template <typename SampleType>
+bool ModulationStage<SampleType>::isActive() const noexcept
+{
+    return hasRings && (mix.getTargetValue() > 0.0f || mix.isSmoothing());
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::stepLfo(int numSamples) noexcept
+{
+    auto rotationCos = stepCos, rotationSin = stepSin;
+
+    // Only a block's last, short control step needs its own rotation
+    if (numSamples != controlInterval)
+    {
+        const auto angle = getStepAngle(rate, numSamples, currentSampleRate);
+        rotationCos = (float)std::cos(angle);
+        rotationSin = (float)std::sin(angle);
+    }
+
+    const auto c = Register::expand((SampleType)rotationCos);
+    const auto s = Register::expand((SampleType)rotationSin);
+
+    for (size_t r = 0; r < (size_t)numRegisters; ++r)
+    {
+        const auto oldCos = lfoCos[r];
+        lfoCos[r] = oldCos * c - lfoSin[r] * s;
+        lfoSin[r] = lfoSin[r] * c + oldCos * s;
+
+        // Pull the amplitude back to 1, or rounding would let it drift over time
+        const auto correction = Register::expand((SampleType)1.5) - (lfoCos[r] * lfoCos[r] + lfoSin[r] * lfoSin[r]) * Register::expand((SampleType)0.5);
+        lfoCos[r] = lfoCos[r] * correction;
+        lfoSin[r] = lfoSin[r] * correction;
+    }
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::updateTargets(int numSamples) noexcept
+{
+    alignas(Register::SIMDRegisterSize) SampleType lfo[numLanes];
+    alignas(Register::SIMDRegisterSize) SampleType targets[numLanes] {};
+    store(lfoSin, lfo);
+
+    if (mode == Mode::phaser)
+    {
+        // Bilinear first-order allpass coefficient for each voice's break frequency
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            const auto frequency = juce::jmin(getPhaserFrequency(depth, (float)lfo[voice]), 0.45f * (float)currentSampleRate);
+            const auto w = std::tan(juce::MathConstants<float>::pi * frequency / (float)currentSampleRate);
+            targets[voice] = (SampleType)((w - 1.0f) / (w + 1.0f));
+        }
+    }
+    else
+    {
+        for (int voice = 0; voice < numVoices; ++voice)
+            targets[voice] = (SampleType)(getDelayMilliseconds(mode, depth, (float)lfo[voice]) * 0.001f * (float)currentSampleRate);
+    }
+
+    const auto next = load(targets);
+
+    if (snapModulation)
+    {
+        modulation = next;
+        modulationStep = {};
+        snapModulation = false;
+        return;
+    }
+
+    const auto perSample = Register::expand((SampleType)1 / (SampleType)numSamples);
+
+    for (size_t r = 0; r < (size_t)numRegisters; ++r)
+        modulationStep[r] = (next[r] - modulation[r]) * perSample;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto numChannels = juce::jmin((int)block.getNumChannels(), (int)lines.size());
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (! hasRings || numChannels == 0 || numSamples == 0)
+        return;
+
+    // Coming back after a rest, or in a new mode, starts from silence. There's
+    // nothing to fade then, so a mode change still pending takes effect now.
+    if (needsClear)
+    {
+        mode = pendingMode;
+        modeFade.setCurrentAndTargetValue(1.0f);
+        clear();
+    }
+
+    for (int start = 0; start < numSamples; start += controlInterval)
+    {
+        const auto count = juce::jmin(controlInterval, numSamples - start);
+
+        if (pendingMode != mode && modeFade.getCurrentValue() <= 0.0f)
+        {
+            mode = pendingMode;
+            clear();
+            modeFade.setTargetValue(1.0f);
+        }
+
+        stepLfo(count);
+        updateTargets(count);
+
+        if (mode == Mode::phaser)
+            processPhaser(block, start, count, numChannels);
+        else
+            processDelays(block, start, count, numChannels);
+    }
+
+    // Once the mix is fully down the caller stops calling, so clear on the way back
+    if (! isActive())
+        needsClear = true;
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::processDelays(const juce::dsp::AudioBlock<SampleType>& block, int start, int numSamples, int numChannels) noexcept
+{
+    SampleType* channelData[2] = { block.getChannelPointer(0) + start,
+                                   numChannels > 1 ? block.getChannelPointer(1) + start : nullptr };
+
+    alignas(Register::SIMDRegisterSize) SampleType delays[numLanes];
+    alignas(Register::SIMDRegisterSize) SampleType fractions[numLanes] {};
+    alignas(Register::SIMDRegisterSize) SampleType taps[4][numLanes] {};
+    alignas(Register::SIMDRegisterSize) SampleType wet[numLanes];
+
+    const auto sixth = (SampleType)1 / 6;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        for (size_t r = 0; r < (size_t)numRegisters; ++r)
+            modulation[r] += modulationStep[r];
+
+        store(modulation, delays);
+
+        // The only scalar part: each voice's four taps, centred on its read point
+        // as in FractionalDelayLine's Lagrange read
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            const auto& line = lines[(size_t)voiceChannels[voice]];
+            const auto whole = (int)delays[voice];
+
+            fractions[voice] = delays[voice] - (SampleType)whole + 1;
+            taps[0][voice] = line.readInteger(whole - 1);
+            taps[1][voice] = line.readInteger(whole);
+            taps[2][voice] = line.readInteger(whole + 1);
+            taps[3][voice] = line.readInteger(whole + 2);
+        }
+
+        // 3rd order Lagrange interpolation, all voices at once
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            const auto offset = r * lanes;
+            const auto f = Register::fromRawArray(fractions + offset);
+            const auto d1 = f - Register::expand(1);
+            const auto d2 = f - Register::expand(2);
+            const auto d3 = f - Register::expand(3);
+
+            const auto c0 = d1 * d2 * d3 * Register::expand(-sixth);
+            const auto c1 = d2 * d3 * Register::expand((SampleType)0.5);
+            const auto c2 = d1 * d3 * Register::expand((SampleType)-0.5);
+            const auto c3 = d1 * d2 * Register::expand(sixth);
+
+            const auto y = Register::fromRawArray(taps[0] + offset) * c0
+                           + f * (Register::fromRawArray(taps[1] + offset) * c1
+                                  + Register::fromRawArray(taps[2] + offset) * c2
+                                  + Register::fromRawArray(taps[3] + offset) * c3);
+
+            y.copyToRawArray(wet + offset);
+        }
+
+        const auto feedbackGain = (SampleType)feedback.getNextValue();
+        const auto wetGain = (SampleType)(mix.getNextValue() * modeFade.getNextValue());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto voices = numChannels > 1 ? (SampleType)0.5 * (wet[channel * 2] + wet[channel * 2 + 1])
+                                                : (SampleType)0.25 * (wet[0] + wet[1] + wet[2] + wet[3]);
+            const auto input = channelData[channel][sample];
+
+            lines[(size_t)channel].write(input + feedbackGain * voices);
+            channelData[channel][sample] = input + wetGain * (voices - input);
+        }
+    }
+}
+
+template <typename SampleType>
+void ModulationStage<SampleType>::processPhaser(const juce::dsp::AudioBlock<SampleType>& block, int start, int numSamples, int numChannels) noexcept
+{
+    SampleType* channelData[2] = { block.getChannelPointer(0) + start,
+                                   numChannels > 1 ? block.getChannelPointer(1) + start : nullptr };
+
+    alignas(Register::SIMDRegisterSize) SampleType inputs[numLanes] {};
+    alignas(Register::SIMDRegisterSize) SampleType wet[numLanes];
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        for (int voice = 0; voice < numVoices; ++voice)
+            inputs[voice] = channelData[voiceChannels[voice]][sample];
+
+        const auto feedbackGain = Register::expand((SampleType)feedback.getNextValue());
+
+        // Every voice's allpass cascade in step: y = a * x + s, s = x - a * y
+        for (size_t r = 0; r < (size_t)numRegisters; ++r)
+        {
+            modulation[r] += modulationStep[r];
+
+            const auto a = modulation[r];
+            auto x = Register::fromRawArray(inputs + r * lanes) + phaserOutput[r] * feedbackGain;
+
+            for (auto& states : allpassStates)
+            {
+                const auto y = a * x + states[r];
+                states[r] = x - a * y;
+                x = y;
+            }
+
+            phaserOutput[r] = x;
+            x.copyToRawArray(wet + r * lanes);
+        }
+
+        const auto wetGain = (SampleType)(mix.getNextValue() * modeFade.getNextValue());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto voices = numChannels > 1 ? (SampleType)0.5 * (wet[channel * 2] + wet[channel * 2 + 1])
+                                                : (SampleType)0.25 * (wet[0] + wet[1] + wet[2] + wet[3]);
+            const auto input = channelData[channel][sample];
+
+            channelData[channel][sample] = input + wetGain * (voices - input);
+        }
+    }
+}
+
+template class ModulationStage<float>;
+template class ModulationStage<double>;
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FractionalDelayLine.h"
+#include "LaneRegister.h"
+
+// Chorus, flanger and phaser, sharing one set of modulated voices.
+//
+// Four voices run side by side as SIMD lanes: two per channel, or all four on
+// a mono bus. Each voice follows its own phase of one LFO. In chorus and
+// flanger modes the voices are taps into a short ring per channel. The rings
+// are FractionalDelayLines over one block of caller-owned storage, as in
+// MultiChannelDelay, and are read with 3rd order Lagrange interpolation worked
+// out for all lanes at once. The flanger's shorter delays feed back into the
+// ring. In phaser mode each voice runs its channel through a cascade of
+// first-order allpass sections whose break frequency the LFO sweeps, with the
+// cascade's output fed back to its input.
+//
+// The LFO is a recursive quadrature oscillator, rotated once per
+// controlInterval samples. The delay times and allpass coefficients it sets
+// are ramped linearly in between, so nothing per sample calls sin, exp or tan.
+//
+// Voices, rings and LFO all run in SampleType; at double precision a register
+// holds half as many voices. Without JUCE_USE_SIMD the lanes run one at a time.
+template <typename SampleType>
+class ModulationStage
+{
+public:
+    enum class Mode
+    {
+        chorus = 0,
+        flanger,
+        phaser
+    };
+
+    static constexpr int numVoices = 4;
+    static constexpr int numPhaserStages = 6;
+    static constexpr int controlInterval = 16;     // samples per LFO step
+
+    ModulationStage() = default;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept;
+
+    // Samples of storage the rings need after prepare(). setStorage() takes it
+    // zeroed, or nullptr to let go of it; the stage is inactive without any.
+    int getRequiredStorage() const noexcept { return (int)lines.size() * ringLength; }
+    void setStorage(SampleType* storage) noexcept;
+    bool hasStorage() const noexcept { return hasRings; }
+
+    // mode 0..2 (a new mode fades in from silence), rate in Hz, depth and mix 0..1, feedback -1..1
+    void setParameters(int mode, float rateHz, float depth, float feedback, float mix) noexcept;
+
+    // Modulates a mono or stereo block in place:
+    // out = in * (1 - mix) + voices * mix. Channels past the second pass through dry.
+    void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // False once the mix has faded to zero, or with no storage; processing can be skipped then
+    bool isActive() const noexcept;
+
+    // Where a voice's delay (ms) or allpass break frequency (Hz) sits at an LFO
+    // value of -1..1. The editor uses these to draw the sweep.
+    static float getDelayMilliseconds(Mode mode, float depth, float lfo) noexcept;
+    static float getPhaserFrequency(float depth, float lfo) noexcept;
+
+    // LFO phase of a voice, in cycles, for the given mode
+    static float getVoicePhase(Mode mode, int voice) noexcept;
+
+    // An upper bound on how long the stage rings after its input goes silent,
+    // until a full-scale signal has fallen below floorDb
+    static double getTailSeconds(Mode mode, float depth, float feedback, float floorDb) noexcept;
+
+private:
+    using Register = LaneRegister<SampleType>;
+
+    // An 8-lane AVX float register holds more than the four voices, so the
+    // voices are padded up to whole registers. The spare lanes start at zero
+    // and stay there: no input reaches them and nothing reads them back.
+    static constexpr int lanes = (int)Register::SIMDNumElements;
+    static constexpr int numRegisters = (numVoices + lanes - 1) / lanes;
+    static constexpr int numLanes = numRegisters * lanes;
+
+    using Vector = std::array<Register, numRegisters>;
+
+    void clear() noexcept;
+    void resetLfo() noexcept;
+    void stepLfo(int numSamples) noexcept;
+    void updateTargets(int numSamples) noexcept;
+    void processDelays(const juce::dsp::AudioBlock<SampleType>& block, int start, int numSamples, int numChannels) noexcept;
+    void processPhaser(const juce::dsp::AudioBlock<SampleType>& block, int start, int numSamples, int numChannels) noexcept;
+
+    static Vector load(const SampleType* source) noexcept;
+    static void store(const Vector& source, SampleType* destination) noexcept;
+
+    // One short ring per channel, side by side in the storage
+    std::vector<FractionalDelayLine<SampleType>> lines;
+    int ringLength = 0;
+    bool hasRings = false;
+    int voiceChannels[numVoices] {};
+
+    // LFO: cos and sin of each voice's phase, and the rotation per control step
+    Vector lfoCos {}, lfoSin {};
+    float stepCos = 1.0f, stepSin = 0.0f;
+
+    // What the voices are following: delay in samples or allpass coefficient,
+    // where it is now and how far it moves per sample in this control step
+    Vector modulation {}, modulationStep {};
+    bool snapModulation = true;
+
+    // Phaser state: one register set per allpass section, plus the fed-back output
+    std::array<Vector, numPhaserStages> allpassStates {};
+    Vector phaserOutput {};
+
+    // The mode being processed, and the one set; they differ while the wet
+    // signal fades out ahead of a mode change
+    Mode mode = Mode::chorus, pendingMode = Mode::chorus;
+    float rate = 1.0f;
+    float depth = 0.5f;
+    juce::SmoothedValue<float> feedback, mix, modeFade;
+    double currentSampleRate = 44100.0;
+    bool needsClear = false;
+    bool snapToTargets = true;   // the first settings after reset() apply without a ramp
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationStage)
+};
\ No newline at end of file
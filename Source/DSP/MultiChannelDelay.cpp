@@ -0,0 +1,293 @@
+#include "MultiChannelDelay.h"
+
+namespace
+{
+    // Long enough that sweeping the delay time sounds like a tape speed change, not a zip
+    constexpr double delayRampSeconds = 0.1;
+
+    // Feedback and mix only need to be fast enough to follow automation without zipper noise
+    constexpr double parameterRampSeconds = 0.05;
+
+    // Longest run handled in one go; the delayed samples for it sit on the stack
+    constexpr int maxRunLength = 256;
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::prepare(int numChannels, int maxDelaySamples, double sampleRate)
+{
+    ringStride = DelayLine::getRequiredStorage(maxDelaySamples);
+    ringLength = ringStride;
+    maxDelay = 0;
+    rings = nullptr;
+
+    channels.resize((size_t)numChannels);
+
+    // The rings wait for setStorage(); the old storage may already be gone
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& state = channels[(size_t)channel];
+        state.line.setStorage(nullptr, ringLength);
+        state.line.prepareSmoothing(sampleRate, delayRampSeconds);
+        state.feedback.reset(sampleRate, parameterRampSeconds);
+        state.mix.reset(sampleRate, parameterRampSeconds);
+    }
+
+    hasRings = false;
+    reset();
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::setStorage(SampleType* storage, int newRingLength) noexcept
+{
+    jassert(storage == nullptr || (juce::isPowerOfTwo(newRingLength) && newRingLength <= ringStride));
+
+    if (storage != nullptr && storage == rings && hasRings)
+    {
+        // More of the same storage: each ring grows where it is
+        if (newRingLength > ringLength)
+        {
+            for (auto& state : channels)
+                state.line.grow(newRingLength);
+
+            ringLength = newRingLength;
+            maxDelay = ringLength - 4;
+        }
+
+        return;
+    }
+
+    rings = storage;
+    hasRings = storage != nullptr;
+
+    if (hasRings)
+    {
+        ringLength = newRingLength;
+        maxDelay = ringLength - 4;
+    }
+
+    // New storage comes zeroed, so there's nothing left to clear
+    for (int channel = 0; channel < getNumChannels(); ++channel)
+    {
+        channels[(size_t)channel].line.setStorage(hasRings ? storage + channel * ringStride : nullptr, ringLength);
+        channels[(size_t)channel].staleSamples = 0;
+    }
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::reset()
+{
+    for (auto& state : channels)
+    {
+        state.line.reset();
+        state.quietSamples = 2 * ringLength;
+        state.staleSamples = 0;
+    }
+
+    snapToTargets = true;
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::setInterpolation(int mode) noexcept
+{
+    interpolation = (Interpolation)juce::jlimit(0, 2, mode);
+}
+
+template <typename SampleType>
+bool MultiChannelDelay<SampleType>::isSmoothing() const noexcept
+{
+    for (auto& state : channels)
+        if (state.line.isSmoothing() || state.feedback.isSmoothing() || state.mix.isSmoothing())
+            return true;
+
+    return false;
+}
+
+template <typename SampleType>
+bool MultiChannelDelay<SampleType>::isSilent() const noexcept
+{
+    if (! hasRings)
+        return true;
+
+    // The taps can reach back a few samples past the delay for the interpolator
+    for (auto& state : channels)
+        if (state.line.isSmoothing() || state.quietSamples <= (int)std::ceil(state.line.getCurrentDelay()) + 4)
+            return false;
+
+    return true;
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::forgetStale() noexcept
+{
+    if (! hasRings)
+        return;
+
+    // Everything written before the quiet part, back to the far end of the ring
+    for (auto& state : channels)
+        state.staleSamples = juce::jmax(0, ringLength - state.quietSamples);
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::clearStale(int maxSamples) noexcept
+{
+    for (auto& state : channels)
+    {
+        if (state.staleSamples == 0)
+            continue;
+
+        if (maxSamples <= 0)
+            return;
+
+        const auto numSamples = juce::jmin(state.staleSamples, maxSamples);
+        state.line.clearHistory(state.quietSamples + state.staleSamples, numSamples);
+        state.staleSamples -= numSamples;
+        maxSamples -= numSamples;
+
+        // All that's left is below the threshold
+        if (state.staleSamples == 0)
+            state.quietSamples = 2 * ringLength;
+    }
+}
+
+template <typename SampleType>
+double MultiChannelDelay<SampleType>::getTailLength(double delayLength, float feedback, float floorDb) noexcept
+{
+    const auto feedbackDb = juce::Decibels::gainToDecibels(std::abs(feedback), floorDb);
+
+    if (feedbackDb <= floorDb)
+        return delayLength;
+
+    return delayLength * (1.0 + std::ceil(floorDb / juce::jmin(feedbackDb, -0.01f)));
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::process(const juce::dsp::AudioBlock<SampleType>& block, float delaySamples, float feedback, float mix,
+                                            int rampLength) noexcept
+{
+    const auto numChannels = juce::jmin((int)block.getNumChannels(), (int)channels.size());
+    const auto numSamples = (int)block.getNumSamples();
+
+    if (! hasRings)
+        return;
+
+    const auto delay = (SampleType)juce::jmin(delaySamples, (float)maxDelay);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& state = channels[(size_t)channel];
+        auto* channelData = block.getChannelPointer((size_t)channel);
+
+        if (rampLength > 0)
+            state.line.setDelay(delay, rampLength);
+        else
+            state.line.setDelay(delay);
+
+        if (snapToTargets)
+        {
+            state.feedback.setCurrentAndTargetValue((SampleType)feedback);
+            state.mix.setCurrentAndTargetValue((SampleType)mix);
+        }
+        else
+        {
+            state.feedback.setTargetValue((SampleType)feedback);
+            state.mix.setTargetValue((SampleType)mix);
+        }
+
+        state.tapPeak = 0.0f;
+
+        // Pick the interpolator once per block so the sample loop doesn't branch on it
+        switch (interpolation)
+        {
+            case Interpolation::linear:   this->template processChannel<Interpolation::linear>(state, channelData, numSamples); break;
+            case Interpolation::lagrange: this->template processChannel<Interpolation::lagrange>(state, channelData, numSamples); break;
+            case Interpolation::thiran:   this->template processChannel<Interpolation::thiran>(state, channelData, numSamples); break;
+        }
+    }
+
+    snapToTargets = false;
+}
+
+template <typename SampleType>
+template <typename MultiChannelDelay<SampleType>::Interpolation mode>
+void MultiChannelDelay<SampleType>::processChannel(ChannelState& state, SampleType* channelData, int numSamples) noexcept
+{
+    auto& line = state.line;
+    SampleType delayed[maxRunLength];
+    int sample = 0;
+
+    while (sample < numSamples)
+    {
+        const int run = line.isSmoothing() ? 0 : line.getContiguousRun(juce::jmin(numSamples - sample, maxRunLength));
+
+        // Gliding to a new delay time, or a tap straddles the end of the ring: one sample at a time
+        if (run <= 0)
+        {
+            const auto in = channelData[sample];
+            const auto out = line.template read<mode>(line.getNextDelay());
+            const auto feedback = state.feedback.getNextValue();
+            const auto mix = state.mix.getNextValue();
+
+            const auto written = in + out * feedback;
+            line.write(written);
+            channelData[sample] = in + (out - in) * mix;
+            trackSilence(state, (float)std::abs(written), 1);
+
+            if (tapMetering)
+                state.tapPeak = juce::jmax(state.tapPeak, (float)std::abs(out));
+
+            ++sample;
+            continue;
+        }
+
+        // Settled delay: read, feed back and mix the whole run as vector operations
+        auto* io = channelData + sample;
+        auto* ring = line.getWritePointer();
+
+        line.template readBlock<mode>(delayed, run);
+        juce::FloatVectorOperations::copy(ring, io, run);
+
+        if (tapMetering)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(delayed, run);
+            state.tapPeak = juce::jmax(state.tapPeak, (float)-range.getStart(), (float)range.getEnd());
+        }
+
+        // out = in + (delayed - in) * mix, so the wet/dry blend is a single ramped multiply-add
+        if (state.feedback.isSmoothing() || state.mix.isSmoothing())
+        {
+            SampleType feedbackRamp[maxRunLength], mixRamp[maxRunLength];
+
+            for (int i = 0; i < run; ++i)
+            {
+                feedbackRamp[i] = state.feedback.getNextValue();
+                mixRamp[i] = state.mix.getNextValue();
+            }
+
+            juce::FloatVectorOperations::addWithMultiply(ring, delayed, feedbackRamp, run);
+            juce::FloatVectorOperations::subtract(delayed, io, run);
+            juce::FloatVectorOperations::addWithMultiply(io, delayed, mixRamp, run);
+        }
+        else
+        {
+            juce::FloatVectorOperations::addWithMultiply(ring, delayed, state.feedback.getTargetValue(), run);
+            juce::FloatVectorOperations::subtract(delayed, io, run);
+            juce::FloatVectorOperations::addWithMultiply(io, delayed, state.mix.getTargetValue(), run);
+        }
+
+        const auto written = juce::FloatVectorOperations::findMinAndMax(ring, run);
+        trackSilence(state, (float)juce::jmax(-written.getStart(), written.getEnd()), run);
+
+        line.advanceWrite(run);
+        sample += run;
+    }
+}
+
+template <typename SampleType>
+void MultiChannelDelay<SampleType>::trackSilence(ChannelState& state, float peak, int numSamples) const noexcept
+{
+    // Capped past the ring, which is as far back as any tap can see
+    state.quietSamples = peak > silenceThreshold ? 0 : juce::jmin(state.quietSamples + numSamples, 2 * ringLength);
+}
+
+template class MultiChannelDelay<float>;
+template class MultiChannelDelay<double>;
\ No newline at end of file
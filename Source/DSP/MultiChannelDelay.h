@@ -0,0 +1,114 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FractionalDelayLine.h"
+
+// Feedback delay with an independent ring buffer and write head per channel.
+//
+// All rings live in one channel-major block of caller-owned storage, sized for
+// however many channels the current bus layout has. Each channel's part is
+// laid out for the longest delay the rings may ever need, but a ring only
+// uses as much of it as the caller has handed over so far, and grows in place
+// when given more. Channels share no state,
+// so a channel's loop only ever touches its own ring. Each ring is read through
+// a FractionalDelayLine, so the delay time can be fractional and glides to new
+// values instead of jumping. Feedback and mix ramp per sample as well.
+//
+// The rings hold SampleType. At double precision, a long delay with high
+// feedback keeps the precision of the signal that goes round it, rather
+// than rounding it to float on every pass.
+template <typename SampleType>
+class MultiChannelDelay
+{
+public:
+    using DelayLine = FractionalDelayLine<SampleType>;
+    using Interpolation = typename DelayLine::Interpolation;
+
+    MultiChannelDelay() = default;
+
+    // maxDelaySamples is the longest delay the rings can ever grow to hold
+    void prepare(int numChannels, int maxDelaySamples, double sampleRate);
+    void reset();
+
+    // Samples of storage the rings are laid out over after prepare(), one
+    // equal part per channel. setStorage() takes it zeroed, along with how
+    // much of each part the rings may use (a getRingLength()), or nullptr to
+    // let go of it; process() does nothing without any. Given the same storage
+    // with a longer ringLength, the rings grow and keep their history.
+    int getRequiredStorage() const noexcept { return getNumChannels() * ringStride; }
+    void setStorage(SampleType* storage, int ringLength) noexcept;
+    bool hasStorage() const noexcept { return hasRings; }
+    int getRingLength() const noexcept { return ringLength; }
+
+    // Samples per channel a ring needs to hold delays up to delaySamples
+    static int getRingLength(int delaySamples) { return DelayLine::getRequiredStorage(delaySamples); }
+
+    // 0 = linear, 1 = lagrange, 2 = allpass
+    void setInterpolation(int mode) noexcept;
+
+    // Delays block in place: out = in * (1 - mix) + delayed * mix,
+    // and in + delayed * feedback goes back into the ring.
+    // A new delay time normally glides in over 100 ms; with a rampLength it is
+    // reached exactly that many samples in instead, so a tempo-synced time can
+    // land at the end of the host's block even when that comes in pieces.
+    void process(const juce::dsp::AudioBlock<SampleType>& block, float delaySamples, float feedback, float mix,
+                 int rampLength = 0) noexcept;
+
+    // True while the delay time, feedback or mix is still ramping to its target
+    bool isSmoothing() const noexcept;
+
+    // Silence tracking. process() counts, per channel, the samples since
+    // anything above the threshold went into the ring. Once that covers the
+    // whole delay, every tap from then on is quieter, and feedback below 1
+    // keeps it that way: the delay has nothing left to play back.
+    void setSilenceThreshold(float gain) noexcept { silenceThreshold = gain; }
+    bool isSilent() const noexcept;
+
+    // Forgetting what the rings hold without clearing them in one go. A ring
+    // that's been quiet for a while only holds anything audible further back
+    // than that; forgetStale() marks that part, and clearStale() zeroes up to
+    // maxSamples of it across the channels per call, oldest first. Writing
+    // moves the history along, so the caller finishes the clear (with no
+    // limit) before the next process().
+    void forgetStale() noexcept;
+    void clearStale(int maxSamples) noexcept;
+
+    // How long a full-scale echo takes to die away below floorDb, in the delay's
+    // units: the first pass, then one more for every repeat the feedback needs
+    static double getTailLength(double delayLength, float feedback, float floorDb) noexcept;
+
+    // When on, process() records the peak of the delayed signal per channel
+    void setTapMetering(bool shouldMeter) noexcept { tapMetering = shouldMeter; }
+    float getTapPeak(int channel) const noexcept { return channels[(size_t)channel].tapPeak; }
+
+    int getNumChannels() const noexcept { return (int)channels.size(); }
+    // The longest delay the rings hold as they are; longer times are clamped to it
+    int getMaxDelaySamples() const noexcept { return maxDelay; }
+
+private:
+    struct ChannelState
+    {
+        DelayLine line;
+        juce::SmoothedValue<SampleType> feedback, mix;
+        float tapPeak = 0.0f;
+        int quietSamples = 0;   // since the ring was last written above the silence threshold
+        int staleSamples = 0;   // still to clear, from just before the quiet part back
+    };
+
+    template <Interpolation mode>
+    void processChannel(ChannelState& state, SampleType* channelData, int numSamples) noexcept;
+    void trackSilence(ChannelState& state, float peak, int numSamples) const noexcept;
+
+    std::vector<ChannelState> channels;
+    Interpolation interpolation = Interpolation::lagrange;
+    int ringStride = 0;   // samples laid out per channel
+    int ringLength = 0;   // samples of that each ring uses
+    int maxDelay = 0;
+    SampleType* rings = nullptr;
+    bool hasRings = false;
+    float silenceThreshold = 0.0f;
+    bool snapToTargets = true;   // the first feedback and mix after reset() apply without a ramp
+    bool tapMetering = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiChannelDelay)
+};
\ No newline at end of file
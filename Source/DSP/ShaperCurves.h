@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Transfer functions for the distortion types.
+//
+// Every curve can be written as outputScale(drive) * shape(drive * x), so the
+// shapes themselves never depend on the distortion amount. That lets the DSP
+// tabulate them once per type and only update two scalars when the amount moves.
+namespace ShaperCurves
+{
+    enum Type
+    {
+        softClip = 0,
+        hardClip,
+        tube,
+        diode,
+        fold,
+        sine,
+        numTypes
+    };
+
+    // Highest input level the shapers are specified for (+12 dBFS)
+    constexpr float maxInputLevel = 4.0f;
+
+    // Drive at the top of the 0..2 distortion range
+    constexpr float maxDrive = 1.0f + 20.0f * 2.0f * 2.0f;
+
+    inline float driveForAmount(float amount)
+    {
+        return 1.0f + 20.0f * amount * amount;
+    }
+
+    // Curve evaluated on the driven input u = drive * x
+    inline float shape(int type, float u)
+    {
+        switch (type)
+        {
+        case softClip:
+            return std::tanh(u);
+
+        case hardClip:
+            return juce::jlimit(-1.0f, 1.0f, u) * 0.5f;
+
+        case tube:
+            return u > 0 ? 1.0f - std::exp(-u) : -1.0f + std::exp(u);
+
+        case diode:
+            return u / (1.0f + std::abs(u)) * (u > 0 ? 0.9f : 1.0f);
+
+        case fold:
+            return std::sin(3.0f * u) / (1.0f + 0.6f * std::abs(u));
+
+        case sine:
+            return std::sin(u * juce::MathConstants<float>::pi * 0.5f);
+        }
+
+        return u;
+    }
+
+    // Gain applied after the shape so that a full-scale input maps to the curve's nominal peak
+    inline float outputScale(int type, float drive)
+    {
+        return type == softClip ? 1.0f / std::tanh(drive) : 1.0f;
+    }
+
+    // Range of u over which a curve has to be known. Saturating curves are flat
+    // (to float precision) outside it, the others need the whole driven input range.
+    inline float shapeRange(int type)
+    {
+        switch (type)
+        {
+        case softClip: return 10.0f;
+        case hardClip: return 2.0f;
+        case tube:     return 20.0f;
+        default:       return maxDrive * maxInputLevel;
+        }
+    }
+
+    // Full curve as seen from the plugin's distortion amount
+    inline float process(int type, float amount, float x)
+    {
+        if (amount <= 0.0f)
+            return x;
+
+        const float drive = driveForAmount(amount);
+        return shape(type, drive * x) * outputScale(type, drive);
+    }
+}
\ No newline at end of file
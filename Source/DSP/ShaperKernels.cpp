@@ -0,0 +1,163 @@
+#include "ShaperKernels.h"
+#include "ShaperKernelsImpl.h"
+
+namespace ShaperKernels
+{
+    namespace
+    {
+        template <typename SampleType>
+        struct ScalarVec
+        {
+            using Sample = SampleType;
+
+            Sample value;
+
+            static constexpr int lanes = 1;
+
+            static ScalarVec broadcast(Sample x) { return { x }; }
+            static ScalarVec load(const Sample* source) { return { *source }; }
+            void store(Sample* dest) const { *dest = value; }
+
+            friend ScalarVec operator+ (ScalarVec a, ScalarVec b) { return { a.value + b.value }; }
+            friend ScalarVec operator- (ScalarVec a, ScalarVec b) { return { a.value - b.value }; }
+            friend ScalarVec operator* (ScalarVec a, ScalarVec b) { return { a.value * b.value }; }
+            friend ScalarVec operator/ (ScalarVec a, ScalarVec b) { return { a.value / b.value }; }
+
+            friend ScalarVec vmin(ScalarVec a, ScalarVec b) { return { juce::jmin(a.value, b.value) }; }
+            friend ScalarVec vmax(ScalarVec a, ScalarVec b) { return { juce::jmax(a.value, b.value) }; }
+            friend ScalarVec vabs(ScalarVec a) { return { std::abs(a.value) }; }
+            friend ScalarVec vfloor(ScalarVec a) { return { std::floor(a.value) }; }
+            friend ScalarVec vmulsign(ScalarVec x, ScalarVec sign) { return { std::signbit(sign.value) ? -x.value : x.value }; }
+            friend ScalarVec vpositive(ScalarVec x, ScalarVec value) { return { x.value > 0 ? value.value : Sample() }; }
+        };
+
+       #if JUCE_USE_SIMD
+        // One juce::dsp::SIMDRegister: SSE2 on x86, NEON on ARM. SIMDRegister has
+        // no division, so that one goes to the native intrinsic directly. JUCE
+        // leaves SIMDRegister out without JUCE_USE_SIMD, and this with it.
+        template <typename SampleType>
+        struct SIMDVec
+        {
+            using Sample = SampleType;
+            using Register = juce::dsp::SIMDRegister<Sample>;
+            using Mask = typename Register::vMaskType;
+            using MaskType = typename Register::MaskType;
+
+            static constexpr MaskType signBit = (MaskType)1 << (sizeof(MaskType) * 8 - 1);
+            static constexpr bool isFloat = std::is_same_v<Sample, float>;
+
+            Register value;
+
+            static constexpr int lanes = (int)Register::SIMDNumElements;
+
+            static SIMDVec broadcast(Sample x) { return { Register::expand(x) }; }
+
+            static SIMDVec load(const Sample* source)
+            {
+                alignas(Register::SIMDRegisterSize) Sample aligned[lanes];
+                std::memcpy(aligned, source, sizeof(aligned));
+                return { Register::fromRawArray(aligned) };
+            }
+
+            void store(Sample* dest) const
+            {
+                alignas(Register::SIMDRegisterSize) Sample aligned[lanes];
+                value.copyToRawArray(aligned);
+                std::memcpy(dest, aligned, sizeof(aligned));
+            }
+
+            friend SIMDVec operator+ (SIMDVec a, SIMDVec b) { return { a.value + b.value }; }
+            friend SIMDVec operator- (SIMDVec a, SIMDVec b) { return { a.value - b.value }; }
+            friend SIMDVec operator* (SIMDVec a, SIMDVec b) { return { a.value * b.value }; }
+
+            friend SIMDVec operator/ (SIMDVec a, SIMDVec b)
+            {
+               #if JUCE_INTEL && defined (__AVX2__)
+                if constexpr (isFloat)
+                    return { Register::fromNative(_mm256_div_ps(a.value.value, b.value.value)) };
+                else
+                    return { Register::fromNative(_mm256_div_pd(a.value.value, b.value.value)) };
+               #elif JUCE_INTEL
+                if constexpr (isFloat)
+                    return { Register::fromNative(_mm_div_ps(a.value.value, b.value.value)) };
+                else
+                    return { Register::fromNative(_mm_div_pd(a.value.value, b.value.value)) };
+               #elif JUCE_ARM && JUCE_64BIT
+                // JUCE keeps NEON doubles as plain pairs, so only float has an intrinsic to call
+                if constexpr (isFloat)
+                    return { Register::fromNative(vdivq_f32(a.value.value, b.value.value)) };
+                else
+                    return divideLanes(a, b);
+               #else
+                return divideLanes(a, b);
+               #endif
+            }
+
+            static SIMDVec divideLanes(SIMDVec a, SIMDVec b)
+            {
+                for (size_t i = 0; i < Register::size(); ++i)
+                    a.value.set(i, a.value.get(i) / b.value.get(i));
+
+                return a;
+            }
+
+            friend SIMDVec vmin(SIMDVec a, SIMDVec b) { return { Register::min(a.value, b.value) }; }
+            friend SIMDVec vmax(SIMDVec a, SIMDVec b) { return { Register::max(a.value, b.value) }; }
+            friend SIMDVec vabs(SIMDVec a) { return { a.value & Mask::expand((MaskType)~signBit) }; }
+
+            friend SIMDVec vfloor(SIMDVec a)
+            {
+                const auto truncated = Register::truncate(a.value);
+                return { truncated - (Register::expand(1) & Register::greaterThan(truncated, a.value)) };
+            }
+
+            // SIMDRegister only combines with masks bitwise, so the sign bit to
+            // flip comes from a comparison rather than from sign's own bits
+            friend SIMDVec vmulsign(SIMDVec x, SIMDVec sign)
+            {
+                return { x.value ^ (Register::lessThan(sign.value, Register::expand(0)) & Mask::expand(signBit)) };
+            }
+
+            friend SIMDVec vpositive(SIMDVec x, SIMDVec value)
+            {
+                return { value.value & Register::greaterThan(x.value, Register::expand(0)) };
+            }
+        };
+       #endif
+    }
+
+    const Kernel& getScalarKernel()
+    {
+        static const Kernel kernel { "Scalar", 1, detail::process<ScalarVec<float>>, detail::process<ScalarVec<double>> };
+        return kernel;
+    }
+
+    const Kernel& getSIMDKernel()
+    {
+       #if JUCE_USE_SIMD && JUCE_INTEL
+        static const Kernel kernel { "SSE2", SIMDVec<float>::lanes, detail::process<SIMDVec<float>>, detail::process<SIMDVec<double>> };
+        return kernel;
+       #elif JUCE_USE_SIMD
+        static const Kernel kernel { "NEON", SIMDVec<float>::lanes, detail::process<SIMDVec<float>>, detail::process<SIMDVec<double>> };
+        return kernel;
+       #else
+        return getScalarKernel();
+       #endif
+    }
+
+    const Kernel& getBestKernel()
+    {
+        static const Kernel& best = []() -> const Kernel&
+        {
+           #if JUCE_INTEL
+            if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+                if (auto* avx = getAVX2Kernel())
+                    return *avx;
+           #endif
+
+            return getSIMDKernel();
+        }();
+
+        return best;
+    }
+}
\ No newline at end of file
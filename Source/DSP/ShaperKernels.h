@@ -0,0 +1,48 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Vectorised evaluation of the distortion curves.
+//
+// The kernels compute outputScale * shape(drive * x) for a block of samples
+// using the polynomial/rational approximations in ShaperKernelsImpl.h instead
+// of libm, so every operation maps onto SIMD lanes. Several builds of the same
+// kernel exist (scalar, SSE2/NEON through juce::dsp::SIMDRegister, AVX2 on x86)
+// and getBestKernel() picks one from the CPU features found at runtime. Each
+// build has a float and a double version, using that type's registers.
+namespace ShaperKernels
+{
+    template <typename SampleType>
+    using ProcessFunction = void (*)(int type, float drive, float outputScale, SampleType* samples, int numSamples);
+
+    struct Kernel
+    {
+        const char* name;
+        int lanes;      // per register, at float precision
+        ProcessFunction<float> processFloat;
+        ProcessFunction<double> processDouble;
+
+        void process(int type, float drive, float outputScale, float* samples, int numSamples) const
+        {
+            processFloat(type, drive, outputScale, samples, numSamples);
+        }
+
+        void process(int type, float drive, float outputScale, double* samples, int numSamples) const
+        {
+            processDouble(type, drive, outputScale, samples, numSamples);
+        }
+    };
+
+    const Kernel& getScalarKernel();
+
+    // SSE2/NEON build, or the scalar one when JUCE_USE_SIMD is off
+    const Kernel& getSIMDKernel();
+
+   #if JUCE_INTEL
+    // AVX2/FMA build, or nullptr if the compiler couldn't target it
+    const Kernel* getAVX2Kernel();
+   #endif
+
+    // Fastest kernel this CPU can run, chosen on first call
+    const Kernel& getBestKernel();
+}
\ No newline at end of file
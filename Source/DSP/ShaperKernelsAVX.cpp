@@ -0,0 +1,129 @@
+#include "ShaperKernels.h"
+#include "ShaperCurves.h"
+
+// AVX2 build of the shaper kernels. Only the code below the target pragma is
+// compiled for AVX2, so this file is safe to link into builds for older CPUs;
+// getBestKernel() only hands it out after checking the CPU at runtime.
+
+#if JUCE_INTEL && (JUCE_MSVC || JUCE_CLANG || JUCE_GCC)
+
+#include <immintrin.h>
+
+#if JUCE_CLANG
+ #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif JUCE_GCC
+ #pragma GCC push_options
+ #pragma GCC target("avx2,fma")
+#endif
+
+// GCC doesn't apply the pragma to functions defined inside a class
+#if JUCE_GCC || JUCE_CLANG
+ #define SHAPER_AVX_TARGET __attribute__((target("avx2,fma")))
+#else
+ #define SHAPER_AVX_TARGET
+#endif
+
+#include "ShaperKernelsImpl.h"
+
+namespace ShaperKernels
+{
+    namespace
+    {
+        template <typename SampleType>
+        struct AVXVec;
+
+        template <>
+        struct AVXVec<float>
+        {
+            using Sample = float;
+
+            __m256 value;
+
+            static constexpr int lanes = 8;
+
+            SHAPER_AVX_TARGET static AVXVec broadcast(float x) { return { _mm256_set1_ps(x) }; }
+            SHAPER_AVX_TARGET static AVXVec load(const float* source) { return { _mm256_loadu_ps(source) }; }
+            SHAPER_AVX_TARGET void store(float* dest) const { _mm256_storeu_ps(dest, value); }
+
+            SHAPER_AVX_TARGET friend AVXVec operator+ (AVXVec a, AVXVec b) { return { _mm256_add_ps(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator- (AVXVec a, AVXVec b) { return { _mm256_sub_ps(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator* (AVXVec a, AVXVec b) { return { _mm256_mul_ps(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator/ (AVXVec a, AVXVec b) { return { _mm256_div_ps(a.value, b.value) }; }
+
+            SHAPER_AVX_TARGET friend AVXVec vmin(AVXVec a, AVXVec b) { return { _mm256_min_ps(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vmax(AVXVec a, AVXVec b) { return { _mm256_max_ps(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vabs(AVXVec a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vfloor(AVXVec a) { return { _mm256_floor_ps(a.value) }; }
+
+            SHAPER_AVX_TARGET friend AVXVec vmulsign(AVXVec x, AVXVec sign)
+            {
+                return { _mm256_xor_ps(x.value, _mm256_and_ps(_mm256_set1_ps(-0.0f), sign.value)) };
+            }
+
+            SHAPER_AVX_TARGET friend AVXVec vpositive(AVXVec x, AVXVec value)
+            {
+                return { _mm256_and_ps(value.value, _mm256_cmp_ps(x.value, _mm256_setzero_ps(), _CMP_GT_OQ)) };
+            }
+        };
+
+        template <>
+        struct AVXVec<double>
+        {
+            using Sample = double;
+
+            __m256d value;
+
+            static constexpr int lanes = 4;
+
+            SHAPER_AVX_TARGET static AVXVec broadcast(double x) { return { _mm256_set1_pd(x) }; }
+            SHAPER_AVX_TARGET static AVXVec load(const double* source) { return { _mm256_loadu_pd(source) }; }
+            SHAPER_AVX_TARGET void store(double* dest) const { _mm256_storeu_pd(dest, value); }
+
+            SHAPER_AVX_TARGET friend AVXVec operator+ (AVXVec a, AVXVec b) { return { _mm256_add_pd(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator- (AVXVec a, AVXVec b) { return { _mm256_sub_pd(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator* (AVXVec a, AVXVec b) { return { _mm256_mul_pd(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec operator/ (AVXVec a, AVXVec b) { return { _mm256_div_pd(a.value, b.value) }; }
+
+            SHAPER_AVX_TARGET friend AVXVec vmin(AVXVec a, AVXVec b) { return { _mm256_min_pd(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vmax(AVXVec a, AVXVec b) { return { _mm256_max_pd(a.value, b.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vabs(AVXVec a) { return { _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.value) }; }
+            SHAPER_AVX_TARGET friend AVXVec vfloor(AVXVec a) { return { _mm256_floor_pd(a.value) }; }
+
+            SHAPER_AVX_TARGET friend AVXVec vmulsign(AVXVec x, AVXVec sign)
+            {
+                return { _mm256_xor_pd(x.value, _mm256_and_pd(_mm256_set1_pd(-0.0), sign.value)) };
+            }
+
+            SHAPER_AVX_TARGET friend AVXVec vpositive(AVXVec x, AVXVec value)
+            {
+                return { _mm256_and_pd(value.value, _mm256_cmp_pd(x.value, _mm256_setzero_pd(), _CMP_GT_OQ)) };
+            }
+        };
+    }
+
+    const Kernel* getAVX2Kernel()
+    {
+        static const Kernel kernel { "AVX2", AVXVec<float>::lanes, detail::process<AVXVec<float>>, detail::process<AVXVec<double>> };
+        return &kernel;
+    }
+}
+
+#undef SHAPER_AVX_TARGET
+
+#if JUCE_CLANG
+ #pragma clang attribute pop
+#elif JUCE_GCC
+ #pragma GCC pop_options
+#endif
+
+#elif JUCE_INTEL
+
+namespace ShaperKernels
+{
+    const Kernel* getAVX2Kernel()
+    {
+        return nullptr;
+    }
+}
+
+#endif
\ No newline at end of file
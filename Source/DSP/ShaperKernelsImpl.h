@@ -0,0 +1,161 @@
+#pragma once
+
+#include "ShaperCurves.h"
+
+// Generic kernel code shared by every instruction-set build in ShaperKernels*.cpp.
+//
+// Vec wraps one register and must provide: the Sample type it holds, static
+// constexpr int lanes, broadcast(), unaligned load()/store(), the + - * /
+// operators and the free functions vmin, vmax, vabs, vfloor, vmulsign(x, sign)
+// (x negated where sign < 0) and vpositive(x, value) (value where x > 0, otherwise 0).
+//
+// Error bounds below are absolute, measured in float against the double
+// precision libm result. The double builds evaluate the same approximations,
+// so they're no closer to the true curves, but they keep the samples around
+// them in double.
+namespace ShaperKernels::detail
+{
+    template <typename Vec, size_t N>
+    inline Vec horner(Vec x, const float (&coefficients)[N])
+    {
+        auto result = Vec::broadcast(coefficients[0]);
+
+        for (size_t i = 1; i < N; ++i)
+            result = result * x + Vec::broadcast(coefficients[i]);
+
+        return result;
+    }
+
+    // tanh: 13/6 odd/even rational minimax fit on [-7.905, 7.905], clamped
+    // outside where tanh rounds to +-1. Error < 3e-7 for all x.
+    template <typename Vec>
+    inline Vec fastTanh(Vec x)
+    {
+        constexpr float limit = 7.90531110763549805f;
+        constexpr float numerator[] = { -2.76076847742355e-16f, 2.00018790482477e-13f, -8.60467152213735e-11f,
+                                        5.12229709037114e-08f, 1.48572235717979e-05f, 6.37261928875436e-04f,
+                                        4.89352455891786e-03f };
+        constexpr float denominator[] = { 1.19825839466702e-06f, 1.18534705686654e-04f, 2.26843463243900e-03f,
+                                          4.89352518554385e-03f };
+
+        x = vmax(Vec::broadcast(-limit), vmin(Vec::broadcast(limit), x));
+        const auto x2 = x * x;
+        return x * horner(x2, numerator) / horner(x2, denominator);
+    }
+
+    // 1 - exp(-a) for a >= 0. A degree 6 Taylor series of -expm1 on a / 64 is
+    // doubled back up six times with c(2a) = c(a) * (2 - c(a)), which keeps the
+    // relative error small for tiny a where 1 - exp(-a) would cancel.
+    // Relative error < 4e-7 on [0, 20], exact 1 above.
+    template <typename Vec>
+    inline Vec fastOneMinusExpNeg(Vec a)
+    {
+        constexpr float series[] = { -1.0f / 720.0f, 1.0f / 120.0f, -1.0f / 24.0f, 1.0f / 6.0f, -0.5f, 1.0f };
+
+        const auto t = vmin(a, Vec::broadcast(20.0f)) * Vec::broadcast(1.0f / 64.0f);
+        auto c = t * horner(t, series);
+        const auto two = Vec::broadcast(2.0f);
+
+        for (int i = 0; i < 6; ++i)
+            c = c * (two - c);
+
+        return c;
+    }
+
+    // sin: Cody-Waite reduction to [-pi, pi] (exact while |x| < ~2^13), folded
+    // onto [0, pi/2] and an 11th order odd Taylor polynomial. Error < 2.5e-7 for
+    // |x| < 1000, which covers the Fold curve's full range.
+    template <typename Vec>
+    inline Vec fastSin(Vec x)
+    {
+        constexpr float series[] = { -2.5052108e-8f, 2.7557319e-6f, -1.9841270e-4f, 8.3333333e-3f, -1.6666667e-1f, 1.0f };
+        constexpr float pi = 3.14159265358979f;
+
+        const auto n = vfloor(x * Vec::broadcast(0.159154943091895f) + Vec::broadcast(0.5f));
+        auto r = x - n * Vec::broadcast(6.28125f);          // exact for the n we see
+        r = r - n * Vec::broadcast(1.9353071795864769e-3f);  // 2pi - 6.28125
+
+        const auto a = vabs(r);
+        const auto folded = vmin(a, Vec::broadcast(pi) - a);
+        return vmulsign(folded * horner(folded * folded, series), r);
+    }
+
+    template <typename Vec>
+    inline Vec shapeSoftClip(Vec u)
+    {
+        return fastTanh(u);
+    }
+
+    template <typename Vec>
+    inline Vec shapeHardClip(Vec u)
+    {
+        return vmax(Vec::broadcast(-1.0f), vmin(Vec::broadcast(1.0f), u)) * Vec::broadcast(0.5f);
+    }
+
+    template <typename Vec>
+    inline Vec shapeTube(Vec u)
+    {
+        return vmulsign(fastOneMinusExpNeg(vabs(u)), u);
+    }
+
+    template <typename Vec>
+    inline Vec shapeDiode(Vec u)
+    {
+        const auto one = Vec::broadcast(1.0f);
+        return u / (one + vabs(u)) * (one - vpositive(u, Vec::broadcast(0.1f)));
+    }
+
+    template <typename Vec>
+    inline Vec shapeFold(Vec u)
+    {
+        return fastSin(u * Vec::broadcast(3.0f)) / (Vec::broadcast(1.0f) + Vec::broadcast(0.6f) * vabs(u));
+    }
+
+    template <typename Vec>
+    inline Vec shapeSine(Vec u)
+    {
+        return fastSin(u * Vec::broadcast(1.57079632679490f));
+    }
+
+    template <typename Vec, typename ShapeFunction>
+    inline void processSamples(ShapeFunction shape, float drive, float outputScale, typename Vec::Sample* samples, int numSamples)
+    {
+        const auto driveVec = Vec::broadcast(drive);
+        const auto scaleVec = Vec::broadcast(outputScale);
+
+        int i = 0;
+
+        for (; i + Vec::lanes <= numSamples; i += Vec::lanes)
+            (shape(Vec::load(samples + i) * driveVec) * scaleVec).store(samples + i);
+
+        // Run the remainder through one padded register so it gets the same approximation
+        if (i < numSamples)
+        {
+            typename Vec::Sample tail[Vec::lanes] = {};
+            const int remaining = numSamples - i;
+
+            for (int j = 0; j < remaining; ++j)
+                tail[j] = samples[i + j];
+
+            (shape(Vec::load(tail) * driveVec) * scaleVec).store(tail);
+
+            for (int j = 0; j < remaining; ++j)
+                samples[i + j] = tail[j];
+        }
+    }
+
+    template <typename Vec>
+    void process(int type, float drive, float outputScale, typename Vec::Sample* samples, int numSamples)
+    {
+        switch (type)
+        {
+        case ShaperCurves::softClip: processSamples<Vec>([](Vec u) { return shapeSoftClip(u); }, drive, outputScale, samples, numSamples); break;
+        case ShaperCurves::hardClip: processSamples<Vec>([](Vec u) { return shapeHardClip(u); }, drive, outputScale, samples, numSamples); break;
+        case ShaperCurves::tube:     processSamples<Vec>([](Vec u) { return shapeTube(u); }, drive, outputScale, samples, numSamples); break;
+        case ShaperCurves::diode:    processSamples<Vec>([](Vec u) { return shapeDiode(u); }, drive, outputScale, samples, numSamples); break;
+        case ShaperCurves::fold:     processSamples<Vec>([](Vec u) { return shapeFold(u); }, drive, outputScale, samples, numSamples); break;
+        case ShaperCurves::sine:     processSamples<Vec>([](Vec u) { return shapeSine(u); }, drive, outputScale, samples, numSamples); break;
+        default: break;
+        }
+    }
+}
\ No newline at end of file
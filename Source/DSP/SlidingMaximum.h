@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Running maximum of the last windowLength values pushed, in O(1) amortised
+// time per value however long the window is.
+//
+// A monotonic deque: the values kept fall strictly from front to back, each
+// tagged with the position it was pushed at. A new value first drops every
+// kept value it's at least as big as, since those can never be the maximum
+// again, and the front drops out once it's older than the window. Every value
+// goes in and comes out once, so the cost per value doesn't grow with the window.
+//
+// The deque lives in a power-of-two ring sized in prepare(), so push() never
+// allocates. Positions are unsigned and compared by difference, so they can
+// wrap without harm.
+template <typename SampleType>
+class SlidingMaximum
+{
+public:
+    void prepare(int maxWindowLength)
+    {
+        // The deque never holds more than a full window plus the value just pushed
+        const auto size = juce::nextPowerOfTwo(juce::jmax(2, maxWindowLength + 1));
+        values.assign((size_t)size, SampleType());
+        positions.assign((size_t)size, 0);
+        mask = (juce::uint32)size - 1;
+        windowLength = juce::jlimit(1, maxWindowLength, windowLength);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        head = tail = 0;
+        position = 0;
+    }
+
+    // A shorter window takes effect on the next push; a longer one fills out as values arrive
+    void setWindowLength(int newLength) noexcept
+    {
+        windowLength = juce::jlimit(1, (int)mask, newLength);
+    }
+
+    int getWindowLength() const noexcept { return windowLength; }
+
+    // Adds a value and returns the maximum of the window ending with it
+    SampleType push(SampleType value) noexcept
+    {
+        while (tail != head && values[(tail - 1) & mask] <= value)
+            --tail;
+
+        values[tail & mask] = value;
+        positions[tail & mask] = position;
+        ++tail;
+
+        while (position - positions[head & mask] >= (juce::uint32)windowLength)
+            ++head;
+
+        ++position;
+        return values[head & mask];
+    }
+
+private:
+    std::vector<SampleType> values;
+    std::vector<juce::uint32> positions;
+    juce::uint32 mask = 0;
+    juce::uint32 head = 0, tail = 0;   // deque is [head, tail), wrapped by mask
+    juce::uint32 position = 0;         // of the next value pushed
+    int windowLength = 1;
+};
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Note divisions for tempo-synced delay times.
+//
+// Divisions run from a whole note down to a 1/32, each as straight, dotted
+// (x1.5) and triplet (x2/3), in that order, so the parameter index is
+// 3 * note + feel.
+namespace TempoSync
+{
+    constexpr int numNotes = 6;    // 1/1, 1/2, 1/4, 1/8, 1/16, 1/32
+    constexpr int numFeels = 3;    // straight, dotted, triplet
+    constexpr int numDivisions = numNotes * numFeels;
+    constexpr int defaultDivision = 2 * numFeels;  // straight 1/4
+
+    // The buffer is sized for the longest division at the slowest tempo
+    constexpr double minBpm = 40.0;
+    constexpr double fallbackBpm = 120.0;
+
+    inline juce::StringArray getDivisionNames()
+    {
+        juce::StringArray names;
+
+        for (int note = 0; note < numNotes; ++note)
+        {
+            const auto name = "1/" + juce::String(1 << note);
+            names.add(name);
+            names.add(name + " D");
+            names.add(name + " T");
+        }
+
+        return names;
+    }
+
+    // Length of a division in quarter-note beats
+    inline double getDivisionBeats(int division)
+    {
+        division = juce::jlimit(0, numDivisions - 1, division);
+
+        const double straight = 4.0 / (double)(1 << (division / numFeels));
+        constexpr double feels[numFeels] = { 1.0, 1.5, 2.0 / 3.0 };
+
+        return straight * feels[division % numFeels];
+    }
+
+    inline double getDelaySeconds(int division, double bpm)
+    {
+        return getDivisionBeats(division) * 60.0 / juce::jmax(minBpm, bpm);
+    }
+
+    // Longest synced delay: a dotted whole note at minBpm, 9 seconds
+    inline double getMaxDelaySeconds()
+    {
+        return getDivisionBeats(1) * 60.0 / minBpm;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,344 @@
+#include "WaveShaper.h"
+
+namespace
+{
+    using Tables = std::array<WaveShaper::Table, ShaperCurves::numTypes>;
+
+    // Below these input differences (in driven units) the divided differences
+    // lose too many digits and the ill-conditioned fallbacks take over
+    constexpr double firstOrderTolerance = 1.0e-6;
+    constexpr double secondOrderTolerance = 1.0e-3;
+
+    void buildIntegrals(WaveShaper::Table& table)
+    {
+        const auto numPoints = table.values.size();
+        const double step = 1.0 / table.scale;
+        const size_t centre = numPoints / 2;
+
+        auto& first = table.firstIntegral;
+        auto& second = table.secondIntegral;
+        first.assign(numPoints, 0.0);
+        second.assign(numPoints, 0.0);
+
+        // Exact integrals of the piecewise linear shape, anchored at u = 0 so the
+        // values (and their rounding errors) stay small where the signal spends most time
+        for (size_t i = 1; i < numPoints; ++i)
+            first[i] = first[i - 1] + step * 0.5 * ((double)table.values[i - 1] + (double)table.values[i]);
+
+        const double firstOffset = first[centre];
+
+        for (auto& value : first)
+            value -= firstOffset;
+
+        for (size_t i = 1; i < numPoints; ++i)
+            second[i] = second[i - 1] + step * first[i - 1]
+                      + step * step * ((double)table.values[i - 1] / 3.0 + (double)table.values[i] / 6.0);
+
+        const double secondOffset = second[centre];
+
+        for (auto& value : second)
+            value -= secondOffset;
+    }
+
+    Tables buildTables()
+    {
+        Tables tables;
+
+        for (int type = 0; type < ShaperCurves::numTypes; ++type)
+        {
+            auto& table = tables[(size_t)type];
+            table.range = ShaperCurves::shapeRange(type);
+            table.scale = (float)WaveShaper::tableSize / (2.0f * table.range);
+            table.values.resize(WaveShaper::tableSize + 1);
+
+            // Computed in double so the grid points land exactly on the curve's kinks
+            const double step = 2.0 * table.range / WaveShaper::tableSize;
+
+            for (int i = 0; i <= WaveShaper::tableSize; ++i)
+            {
+                auto u = (float)(-table.range + step * i);
+                table.values[(size_t)i] = ShaperCurves::shape(type, u);
+            }
+
+            buildIntegrals(table);
+        }
+
+        return tables;
+    }
+
+    const Tables& getTables()
+    {
+        static const Tables tables = buildTables();
+        return tables;
+    }
+
+    // Finds the segment holding u. Outside the table the shape is held at its
+    // end value, which the callers get by treating the slope as zero.
+    struct Segment
+    {
+        size_t index;
+        double offset;  // u minus the segment's start
+        double slope;   // change of the shape across the segment
+    };
+
+    Segment findSegment(const WaveShaper::Table& table, double u) noexcept
+    {
+        const double position = (u + table.range) * table.scale;
+        const double step = 1.0 / table.scale;
+
+        if (position <= 0.0)
+            return { 0, u + table.range, 0.0 };
+
+        if (position >= WaveShaper::tableSize)
+            return { (size_t)WaveShaper::tableSize, u - table.range, 0.0 };
+
+        const auto index = (size_t)position;
+        const double slope = (double)table.values[index + 1] - (double)table.values[index];
+        return { index, (position - (double)index) * step, slope };
+    }
+}
+
+double WaveShaper::Table::getValue(double u) const noexcept
+{
+    const auto segment = findSegment(*this, u);
+    return (double)values[segment.index] + segment.slope * segment.offset * scale;
+}
+
+double WaveShaper::Table::getFirstIntegral(double u) const noexcept
+{
+    const auto segment = findSegment(*this, u);
+    const double s = segment.offset;
+    const double t = s * scale;
+    return firstIntegral[segment.index] + s * ((double)values[segment.index] + segment.slope * t * 0.5);
+}
+
+double WaveShaper::Table::getSecondIntegral(double u) const noexcept
+{
+    const auto segment = findSegment(*this, u);
+    const double s = segment.offset;
+    const double t = s * scale;
+    return secondIntegral[segment.index] + s * firstIntegral[segment.index]
+         + s * s * ((double)values[segment.index] * 0.5 + segment.slope * t / 6.0);
+}
+
+WaveShaper::WaveShaper()
+{
+    // Build the shared tables here rather than on the audio thread. The ADAA
+    // modes need them even when a SIMD kernel handles the plain shaper.
+    getTables();
+
+    // Without SIMD lanes the tables beat evaluating the approximations one sample at a time
+    const auto& best = ShaperKernels::getBestKernel();
+
+    if (best.lanes > 1)
+        kernel = &best;
+
+    setParameters(0.0f, ShaperCurves::softClip);
+}
+
+const WaveShaper::Table& WaveShaper::getTable(int type)
+{
+    return getTables()[(size_t)juce::jlimit(0, ShaperCurves::numTypes - 1, type)];
+}
+
+void WaveShaper::prepare(int numChannels)
+{
+    antialiasingStates.resize((size_t)numChannels);
+    reset();
+}
+
+void WaveShaper::reset()
+{
+    for (auto& state : antialiasingStates)
+        state = {};
+}
+
+void WaveShaper::setParameters(float amount, int type)
+{
+    if (amount == currentAmount && type == currentType)
+        return;
+
+    currentAmount = amount;
+    currentType = type;
+
+    bypassed = amount <= 0.0f;
+    table = &getTable(type);
+    inputDrive = ShaperCurves::driveForAmount(amount);
+    outputScale = ShaperCurves::outputScale(type, inputDrive);
+
+    for (auto& state : antialiasingStates)
+        state.needsRefresh = true;
+}
+
+void WaveShaper::setAntialiasingOrder(int order)
+{
+    order = juce::jlimit(0, 2, order);
+
+    if (order == antialiasingOrder)
+        return;
+
+    antialiasingOrder = order;
+
+    for (auto& state : antialiasingStates)
+        state.needsRefresh = true;
+}
+
+template <typename SampleType>
+void WaveShaper::process(int channel, SampleType* samples, int numSamples, float outputGain) noexcept
+{
+    if (bypassed)
+    {
+        juce::FloatVectorOperations::multiply(samples, (SampleType)outputGain, numSamples);
+        return;
+    }
+
+    if (antialiasingOrder > 0 && juce::isPositiveAndBelow(channel, (int)antialiasingStates.size()))
+    {
+        auto& state = antialiasingStates[(size_t)channel];
+
+        if (state.needsRefresh)
+            refreshHistory(state);
+
+        if (antialiasingOrder == 1)
+            processFirstOrder(state, samples, numSamples, outputScale * outputGain);
+        else
+            processSecondOrder(state, samples, numSamples, outputScale * outputGain);
+
+        return;
+    }
+
+    if (kernel != nullptr)
+    {
+        kernel->process(currentType, inputDrive, outputScale * outputGain, samples, numSamples);
+        return;
+    }
+
+    // The table holds float; a double block is looked up in double all the same
+    const float* values = table->values.data();
+    const auto low = (SampleType)-table->range;
+    const auto high = (SampleType)table->range;
+    const auto indexScale = (SampleType)table->scale;
+    const auto drive = (SampleType)inputDrive;
+    const auto scale = (SampleType)(outputScale * outputGain);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto u = juce::jlimit(low, high, samples[i] * drive);
+        const auto position = (u - low) * indexScale;
+        const int index = juce::jmin((int)position, tableSize - 1);
+        const auto frac = position - (SampleType)index;
+
+        const auto y0 = (SampleType)values[index];
+        const auto y1 = (SampleType)values[index + 1];
+        samples[i] = (y0 + frac * (y1 - y0)) * scale;
+    }
+}
+
+template void WaveShaper::process<float>(int, float*, int, float) noexcept;
+template void WaveShaper::process<double>(int, double*, int, float) noexcept;
+
+// Recomputes the cached integrals from the stored inputs after the drive,
+// type or order changed, so the next divided difference stays consistent
+void WaveShaper::refreshHistory(AntialiasingState& state) const noexcept
+{
+    const double drive = inputDrive;
+    const double u1 = state.x1 * drive;
+    const double u2 = state.x2 * drive;
+
+    state.integral1 = table->getFirstIntegral(u1);
+    state.integral2 = table->getSecondIntegral(u1);
+
+    if (std::abs(u1 - u2) > secondOrderTolerance)
+        state.difference1 = (state.integral2 - table->getSecondIntegral(u2)) / (u1 - u2);
+    else
+        state.difference1 = table->getFirstIntegral(0.5 * (u1 + u2));
+
+    state.needsRefresh = false;
+}
+
+// y[n] = (F1(u[n]) - F1(u[n-1])) / (u[n] - u[n-1]), the mean of the curve between the two inputs
+template <typename SampleType>
+void WaveShaper::processFirstOrder(AntialiasingState& state, SampleType* samples, int numSamples, float scale) noexcept
+{
+    const double drive = inputDrive;
+    const auto& shape = *table;
+
+    double x1 = state.x1, x2 = state.x2;
+    double integral1 = state.integral1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double x0 = samples[i];
+        const double u0 = x0 * drive;
+        const double u1 = x1 * drive;
+        const double integral0 = shape.getFirstIntegral(u0);
+        const double delta = u0 - u1;
+
+        const double y = std::abs(delta) > firstOrderTolerance ? (integral0 - integral1) / delta
+                                                               : shape.getValue(0.5 * (u0 + u1));
+
+        samples[i] = (SampleType)y * (SampleType)scale;
+        x2 = x1;
+        x1 = x0;
+        integral1 = integral0;
+    }
+
+    // x2 is kept so a switch to second order can pick up from here
+    state.x1 = x1;
+    state.x2 = x2;
+    state.integral1 = integral1;
+}
+
+// Second order ADAA after Bilbao et al., "Antiderivative Antialiasing for
+// Memoryless Nonlinearities" (2017), including its fallback for x[n] ~ x[n-2]
+template <typename SampleType>
+void WaveShaper::processSecondOrder(AntialiasingState& state, SampleType* samples, int numSamples, float scale) noexcept
+{
+    const double drive = inputDrive;
+    const auto& shape = *table;
+
+    double x1 = state.x1, x2 = state.x2;
+    double integral2 = state.integral2;
+    double difference1 = state.difference1;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const double x0 = samples[i];
+        const double u0 = x0 * drive;
+        const double u1 = x1 * drive;
+        const double u2 = x2 * drive;
+        const double integral0 = shape.getSecondIntegral(u0);
+
+        const double delta01 = u0 - u1;
+        const double difference0 = std::abs(delta01) > secondOrderTolerance ? (integral0 - integral2) / delta01
+                                                                              : shape.getFirstIntegral(0.5 * (u0 + u1));
+        const double delta02 = u0 - u2;
+        double y;
+
+        if (std::abs(delta02) > secondOrderTolerance)
+        {
+            y = 2.0 * (difference0 - difference1) / delta02;
+        }
+        else
+        {
+            const double mean = 0.5 * (u0 + u2);
+            const double delta = mean - u1;
+
+            if (std::abs(delta) > secondOrderTolerance)
+                y = 2.0 / delta * (shape.getFirstIntegral(mean) + (integral2 - shape.getSecondIntegral(mean)) / delta);
+            else
+                y = shape.getValue(0.5 * (mean + u1));
+        }
+
+        samples[i] = (SampleType)y * (SampleType)scale;
+        x2 = x1;
+        x1 = x0;
+        integral2 = integral0;
+        difference1 = difference0;
+    }
+
+    state.x1 = x1;
+    state.x2 = x2;
+    state.integral2 = integral2;
+    state.difference1 = difference1;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ShaperCurves.h"
+#include "ShaperKernels.h"
+
+// Waveshaper engine.
+//
+// On CPUs with SIMD the curves are evaluated directly by the vectorised kernels
+// in ShaperKernels. Otherwise the shape of each distortion type is tabulated
+// once per process and shared by all instances, and the per-sample loop is a
+// clamp, a lookup and a linear interpolation with no branches.
+//
+// Either way, changing the amount or type only recomputes the input drive and
+// output scale.
+//
+// The shaper can also run with first or second order antiderivative
+// anti-aliasing (ADAA). The tables then carry the exact first and second
+// antiderivatives of the interpolated shape, and each output sample is the
+// average of the curve over the segment between consecutive inputs.
+class WaveShaper
+{
+public:
+    WaveShaper();
+
+    // Allocates the per-channel ADAA history
+    void prepare(int numChannels);
+    void reset();
+
+    // Cheap to call every block; only does work when amount or type changed
+    void setParameters(float amount, int type);
+
+    // 0 = off, 1 = first order, 2 = second order
+    void setAntialiasingOrder(int order);
+    int getAntialiasingOrder() const noexcept { return antialiasingOrder; }
+
+    // Group delay added by ADAA, in samples at the rate the shaper runs at
+    float getAntialiasingDelay() const noexcept { return getAntialiasingDelay(antialiasingOrder); }
+    static float getAntialiasingDelay(int order) noexcept { return (float)juce::jlimit(0, 2, order) * 0.5f; }
+
+    // Shapes the samples in place and applies outputGain, for float or double samples
+    template <typename SampleType>
+    void process(int channel, SampleType* samples, int numSamples, float outputGain) noexcept;
+
+    // True when the table lookup is used instead of a SIMD kernel
+    bool isUsingTable() const noexcept { return kernel == nullptr; }
+
+    static constexpr int tableSize = 1 << 16;
+
+    struct Table
+    {
+        float range = 1.0f;     // table covers u in [-range, range]
+        float scale = 1.0f;     // table index per unit of u
+        std::vector<float> values;  // tableSize + 1 points
+
+        // Antiderivatives of the linearly interpolated shape at the same points,
+        // both zero at u = 0. Outside the range the shape is held constant.
+        std::vector<double> firstIntegral;
+        std::vector<double> secondIntegral;
+
+        double getValue(double u) const noexcept;
+        double getFirstIntegral(double u) const noexcept;
+        double getSecondIntegral(double u) const noexcept;
+    };
+
+    static const Table& getTable(int type);
+
+private:
+    struct AntialiasingState
+    {
+        double x1 = 0.0, x2 = 0.0;        // previous (undriven) inputs
+        double integral1 = 0.0;           // first integral at the driven x1 (first order)
+        double integral2 = 0.0;           // second integral at the driven x1 (second order)
+        double difference1 = 0.0;         // divided difference between x1 and x2 (second order)
+        bool needsRefresh = true;         // cached values predate a drive/type change
+    };
+
+    template <typename SampleType>
+    void processFirstOrder(AntialiasingState&, SampleType* samples, int numSamples, float scale) noexcept;
+
+    template <typename SampleType>
+    void processSecondOrder(AntialiasingState&, SampleType* samples, int numSamples, float scale) noexcept;
+    void refreshHistory(AntialiasingState&) const noexcept;
+
+    const ShaperKernels::Kernel* kernel = nullptr;  // nullptr selects the table path
+    const Table* table = nullptr;
+    float currentAmount = -1.0f;
+    int currentType = -1;
+    float inputDrive = 1.0f;
+    float outputScale = 1.0f;
+    bool bypassed = true;
+
+    int antialiasingOrder = 0;
+    std::vector<AntialiasingState> antialiasingStates;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveShaper)
+};
\ No newline at end of file
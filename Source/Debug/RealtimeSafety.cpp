@@ -0,0 +1,246 @@
+// The hooks redefine libc entry points, which clashes with the inline wrappers
+// _FORTIFY_SOURCE puts in the system headers, so this file opts out of those
+#if defined(REALTIME_SAFETY_CHECKS) && REALTIME_SAFETY_CHECKS
+ #undef _FORTIFY_SOURCE
+#endif
+
+#include "RealtimeSafety.h"
+
+#if REALTIME_SAFETY_CHECKS
+
+#include <cstdio>
+
+#if JUCE_LINUX && defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <unistd.h>
+ #include <cerrno>
+ #include <cstdarg>
+ #include <ctime>
+ #define REALTIME_SAFETY_HOOK_LIBC 1
+#else
+ #define REALTIME_SAFETY_HOOK_LIBC 0
+#endif
+
+namespace RealtimeSafety
+{
+    namespace
+    {
+        constexpr int maxReports = 20;   // after this many, violations are only counted
+
+        // Trivial thread_locals live in static TLS, so reading them from inside
+        // malloc can't itself allocate
+        thread_local int audioThreadDepth = 0;
+        thread_local int exemptionDepth = 0;
+        thread_local bool reporting = false;
+
+        std::atomic<int> numViolations { 0 };
+    }
+
+    void checkCall(const char* function) noexcept
+    {
+        if (audioThreadDepth == 0 || exemptionDepth > 0 || reporting)
+            return;
+
+        // Building the report allocates and locks too
+        reporting = true;
+
+        if (++numViolations <= maxReports)
+            std::fprintf(stderr, "Real-time violation: %s on the audio thread\n%s\n",
+                         function, juce::SystemStats::getStackBacktrace().toRawUTF8());
+
+        reporting = false;
+    }
+
+    ScopedAudioThread::ScopedAudioThread() noexcept { ++audioThreadDepth; }
+    ScopedAudioThread::~ScopedAudioThread() noexcept { --audioThreadDepth; }
+
+    ScopedExemption::ScopedExemption() noexcept { ++exemptionDepth; }
+    ScopedExemption::~ScopedExemption() noexcept { --exemptionDepth; }
+
+    int getNumViolations() noexcept { return numViolations.load(); }
+    void resetViolations() noexcept { numViolations = 0; }
+}
+
+#if REALTIME_SAFETY_HOOK_LIBC
+
+// Definitions here take precedence over libc's for the whole process. The
+// allocator is forwarded to glibc's own entry points; everything else goes to
+// the next definition found by the dynamic linker.
+#define REALTIME_SAFETY_NEXT(function) \
+    static const auto next = reinterpret_cast<decltype(&::function)>(dlsym(RTLD_NEXT, #function))
+
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        RealtimeSafety::checkCall("posix_memalign");
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            RealtimeSafety::checkCall("free");
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        REALTIME_SAFETY_NEXT(pthread_mutex_lock);
+        RealtimeSafety::checkCall("pthread_mutex_lock");
+        return next(mutex);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        REALTIME_SAFETY_NEXT(pthread_cond_wait);
+        RealtimeSafety::checkCall("pthread_cond_wait");
+        return next(condition, mutex);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        REALTIME_SAFETY_NEXT(sem_wait);
+        RealtimeSafety::checkCall("sem_wait");
+        return next(semaphore);
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        REALTIME_SAFETY_NEXT(open);
+        RealtimeSafety::checkCall("open");
+
+        int mode = 0;
+
+        if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE)
+        {
+            va_list args;
+            va_start(args, flags);
+            mode = va_arg(args, int);
+            va_end(args);
+        }
+
+        return next(path, flags, mode);
+    }
+
+    FILE* fopen(const char* path, const char* mode)
+    {
+        REALTIME_SAFETY_NEXT(fopen);
+        RealtimeSafety::checkCall("fopen");
+        return next(path, mode);
+    }
+
+    ssize_t read(int file, void* buffer, size_t size)
+    {
+        REALTIME_SAFETY_NEXT(read);
+        RealtimeSafety::checkCall("read");
+        return next(file, buffer, size);
+    }
+
+    ssize_t write(int file, const void* buffer, size_t size)
+    {
+        REALTIME_SAFETY_NEXT(write);
+        RealtimeSafety::checkCall("write");
+        return next(file, buffer, size);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        REALTIME_SAFETY_NEXT(nanosleep);
+        RealtimeSafety::checkCall("nanosleep");
+        return next(duration, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        REALTIME_SAFETY_NEXT(usleep);
+        RealtimeSafety::checkCall("usleep");
+        return next(microseconds);
+    }
+}
+
+#else
+
+// Without glibc's allocator entry points, catch C++ allocations at least
+void* operator new(std::size_t size)
+{
+    RealtimeSafety::checkCall("operator new");
+
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    RealtimeSafety::checkCall("operator new[]");
+
+    if (auto* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeSafety::checkCall("operator delete");
+
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        RealtimeSafety::checkCall("operator delete[]");
+
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete[](pointer); }
+
+#endif
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Real-time safety checks for the audio thread.
+//
+// Builds with REALTIME_SAFETY_CHECKS=1 (the StressTest tool) hook memory
+// allocation, locking, waiting and blocking file/sleep calls. Any of those made
+// while a ScopedAudioThread is alive on the calling thread is counted and
+// reported on stderr with a stack trace. Allocation hooks cover malloc and
+// friends on glibc, and operator new/delete elsewhere; the lock and system
+// call hooks are glibc only.
+//
+// Without the flag the guards are empty and nothing is hooked, so the plugin
+// can keep them in processBlock at no cost.
+#ifndef REALTIME_SAFETY_CHECKS
+ #define REALTIME_SAFETY_CHECKS 0
+#endif
+
+namespace RealtimeSafety
+{
+#if REALTIME_SAFETY_CHECKS
+    // Marks the current thread as inside the audio callback while in scope
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    // Suspends checking for a call that has been reviewed and accepted,
+    // e.g. a host notification that takes an uncontended lock
+    class ScopedExemption
+    {
+    public:
+        ScopedExemption() noexcept;
+        ~ScopedExemption() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedExemption)
+    };
+
+    int getNumViolations() noexcept;
+    void resetViolations() noexcept;
+#else
+    struct ScopedAudioThread { ScopedAudioThread() noexcept {} };
+    struct ScopedExemption { ScopedExemption() noexcept {} };
+
+    inline int getNumViolations() noexcept { return 0; }
+    inline void resetViolations() noexcept {}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Flat-coloured triangles making up a display's lines and fills, in the
+// display's own pixel coordinates. The same geometry is filled in software by
+// draw() or handed to the GPU by OpenGLDisplayRenderer. A batch's triangles
+// may overlap, as at a polyline's joints; both fill their union once, so a
+// translucent colour comes out even.
+struct DisplayGeometry
+{
+    struct Batch
+    {
+        juce::Colour colour;
+        std::vector<juce::Point<float>> triangles;   // three vertices per triangle
+    };
+
+    std::vector<Batch> batches;
+
+    void clear()
+    {
+        batches.clear();
+        paths.clear();
+    }
+
+    void addRectangle(juce::Rectangle<float> area, juce::Colour colour)
+    {
+        auto& triangles = getBatch(colour).triangles;
+        triangles.insert(triangles.end(), { area.getTopLeft(), area.getTopRight(), area.getBottomRight(),
+                                            area.getTopLeft(), area.getBottomRight(), area.getBottomLeft() });
+    }
+
+    void addLine(juce::Point<float> start, juce::Point<float> end, float thickness, juce::Colour colour)
+    {
+        const auto direction = end - start;
+        const auto length = direction.getDistanceFromOrigin();
+
+        if (length <= 0.0f)
+            return;
+
+        // Half the thickness either side, square ends extended the same amount
+        const auto along = direction * (0.5f * thickness / length);
+        const juce::Point<float> across { -along.y, along.x };
+        const auto a = start - along + across, b = start - along - across;
+        const auto c = end + along - across, d = end + along + across;
+
+        auto& triangles = getBatch(colour).triangles;
+        triangles.insert(triangles.end(), { a, b, c, a, c, d });
+    }
+
+    void addPolyline(const std::vector<juce::Point<float>>& points, float thickness, juce::Colour colour)
+    {
+        for (size_t i = 1; i < points.size(); ++i)
+            addLine(points[i - 1], points[i], thickness, colour);
+    }
+
+    // Software rendering; the paths are built on first use after a change
+    void draw(juce::Graphics& g) const
+    {
+        if (paths.size() != batches.size())
+        {
+            paths.resize(batches.size());
+
+            for (size_t i = 0; i < batches.size(); ++i)
+            {
+                const auto& triangles = batches[i].triangles;
+                paths[i].clear();
+                paths[i].preallocateSpace((int)triangles.size() * 4);
+
+                for (size_t v = 0; v + 2 < triangles.size(); v += 3)
+                    paths[i].addTriangle(triangles[v], triangles[v + 1], triangles[v + 2]);
+            }
+        }
+
+        for (size_t i = 0; i < batches.size(); ++i)
+        {
+            g.setColour(batches[i].colour);
+            g.fillPath(paths[i]);
+        }
+    }
+
+private:
+    Batch& getBatch(juce::Colour colour)
+    {
+        for (auto& batch : batches)
+            if (batch.colour == colour)
+                return batch;
+
+        batches.push_back({ colour, {} });
+        return batches.back();
+    }
+
+    mutable std::vector<juce::Path> paths;
+};
+
+// Base for the editor's displays. Subclasses describe their lines and fills in
+// buildGeometry() and call geometryChanged() when something they show changes.
+// The geometry is rebuilt at most once per display frame, so bursts of
+// parameter changes cost one rebuild. Text goes in paintOverlay(), which is
+// always done in software.
+//
+// When OpenGLDisplayRenderer takes over, the display turns transparent and
+// paints only its overlay; the renderer draws the background and geometry.
+class GeometryDisplay : public juce::Component
+{
+public:
+    explicit GeometryDisplay(juce::Colour backgroundColour)
+        : background(backgroundColour),
+          vBlank(this, [this] { refresh(); })
+    {
+        setOpaque(true);
+    }
+
+    void setGpuRendering(bool shouldUseGpu)
+    {
+        gpuRendering = shouldUseGpu;
+        setOpaque(! gpuRendering);
+        repaint();
+    }
+
+    bool isGpuRendering() const noexcept { return gpuRendering; }
+    juce::Colour getBackgroundColour() const noexcept { return background; }
+    const DisplayGeometry& getGeometry() const noexcept { return geometry; }
+
+    // Called on the message thread after each rebuild
+    std::function<void()> onGeometryChanged;
+
+    void paint(juce::Graphics& g) override
+    {
+        if (! gpuRendering)
+        {
+            g.fillAll(background);
+            geometry.draw(g);
+        }
+
+        paintOverlay(g);
+    }
+
+    void resized() override
+    {
+        rebuild();
+    }
+
+protected:
+    virtual void buildGeometry(DisplayGeometry& geometryToFill) = 0;
+    virtual void paintOverlay(juce::Graphics&) {}
+
+    void geometryChanged() noexcept { isStale = true; }
+
+private:
+    void refresh()
+    {
+        if (isStale)
+        {
+            rebuild();
+            repaint();
+        }
+    }
+
+    void rebuild()
+    {
+        geometry.clear();
+        buildGeometry(geometry);
+        isStale = false;
+
+        if (onGeometryChanged != nullptr)
+            onGeometryChanged();
+    }
+
+    const juce::Colour background;
+    DisplayGeometry geometry;
+    bool isStale = true;
+    bool gpuRendering = false;
+    juce::VBlankAttachment vBlank;
+};
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include "OpenGLDisplayRenderer.h"
+
+namespace
+{
+    // How long to wait for a context before deciding there is no usable GL
+    constexpr int contextTimeoutMs = 2000;
+
+    // Vertices arrive in display pixels; size maps them to clip space, y down
+    const char* vertexShader = R"(
+        attribute vec2 position;
+        uniform vec2 size;
+
+        void main()
+        {
+            gl_Position = vec4(position.x / size.x * 2.0 - 1.0, 1.0 - position.y / size.y * 2.0, 0.0, 1.0);
+        }
+    )";
+
+    const char* fragmentShader = R"(
+        uniform vec4 colour;
+
+        void main()
+        {
+            gl_FragColor = colour;
+        }
+    )";
+}
+
+OpenGLDisplayRenderer::OpenGLDisplayRenderer(juce::Component& targetComponent)
+    : target(targetComponent)
+{
+    juce::OpenGLPixelFormat pixelFormat;
+    pixelFormat.multisamplingLevel = 4;
+    pixelFormat.stencilBufferBits = 8;      // see renderOpenGL()
+    context.setPixelFormat(pixelFormat);
+    context.setMultisamplingEnabled(true);
+    context.setRenderer(this);
+    context.setComponentPaintingEnabled(true);
+    context.setContinuousRepainting(false);
+}
+
+OpenGLDisplayRenderer::~OpenGLDisplayRenderer()
+{
+    cancelPendingUpdate();
+    context.detach();
+
+    for (auto* display : displays)
+    {
+        display->removeComponentListener(this);
+        display->onGeometryChanged = nullptr;
+    }
+}
+
+void OpenGLDisplayRenderer::addDisplay(GeometryDisplay& display)
+{
+    displays.push_back(&display);
+    display.addComponentListener(this);
+    display.onGeometryChanged = [this] { updateSnapshot(); };
+}
+
+void OpenGLDisplayRenderer::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    enabled = shouldBeEnabled;
+
+    if (enabled)
+    {
+        contextCreated = false;
+        contextFailed = false;
+        context.attachTo(target);
+        startTimer(contextTimeoutMs);
+    }
+    else
+    {
+        stopTimer();
+        context.detach();
+        setActive(false);
+    }
+}
+
+void OpenGLDisplayRenderer::excludeDisplays(juce::Graphics& g) const
+{
+    for (auto* display : displays)
+        if (display->isShowing())
+            g.excludeClipRegion(target.getLocalArea(display, display->getLocalBounds()));
+}
+
+void OpenGLDisplayRenderer::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == active)
+        return;
+
+    active = shouldBeActive;
+
+    for (auto* display : displays)
+        display->setGpuRendering(active);
+
+    updateSnapshot();
+    target.repaint();
+}
+
+void OpenGLDisplayRenderer::updateSnapshot()
+{
+    if (! active)
+        return;
+
+    std::vector<DisplaySnapshot> newSnapshot;
+
+    for (auto* display : displays)
+        if (display->isShowing() && ! display->getLocalBounds().isEmpty())
+            newSnapshot.push_back({ target.getLocalArea(display, display->getLocalBounds()),
+                                    display->getBackgroundColour(),
+                                    display->getGeometry().batches });
+
+    {
+        const juce::ScopedLock lock(snapshotLock);
+        snapshot.swap(newSnapshot);
+        targetBounds = target.getLocalBounds();
+    }
+
+    context.triggerRepaint();
+}
+
+void OpenGLDisplayRenderer::componentMovedOrResized(juce::Component&, bool, bool)
+{
+    updateSnapshot();
+}
+
+void OpenGLDisplayRenderer::componentVisibilityChanged(juce::Component&)
+{
+    updateSnapshot();
+}
+
+void OpenGLDisplayRenderer::handleAsyncUpdate()
+{
+    if (! enabled)
+        return;
+
+    if (contextFailed)
+    {
+        // Shaders unsupported: keep painting in software
+        stopTimer();
+        context.detach();
+        setActive(false);
+        return;
+    }
+
+    if (contextCreated)
+    {
+        stopTimer();
+        setActive(true);
+    }
+}
+
+void OpenGLDisplayRenderer::timerCallback()
+{
+    // No context by now means no usable GL on this machine
+    stopTimer();
+
+    if (! contextCreated)
+    {
+        context.detach();
+        setActive(false);
+    }
+}
+
+void OpenGLDisplayRenderer::newOpenGLContextCreated()
+{
+    using namespace juce::gl;
+
+    auto program = std::make_unique<juce::OpenGLShaderProgram>(context);
+
+    if (program->addVertexShader(juce::OpenGLHelpers::translateVertexShaderToV3(vertexShader))
+        && program->addFragmentShader(juce::OpenGLHelpers::translateFragmentShaderToV3(fragmentShader))
+        && program->link())
+    {
+        shader = std::move(program);
+        positionAttribute = std::make_unique<juce::OpenGLShaderProgram::Attribute>(*shader, "position");
+        sizeUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*shader, "size");
+        colourUniform = std::make_unique<juce::OpenGLShaderProgram::Uniform>(*shader, "colour");
+        glGenBuffers(1, &vertexBuffer);
+        contextCreated = true;
+    }
+    else
+    {
+        DBG("Display shader failed: " << program->getLastError());
+        contextFailed = true;
+    }
+
+    triggerAsyncUpdate();
+}
+
+void OpenGLDisplayRenderer::openGLContextClosing()
+{
+    using namespace juce::gl;
+
+    if (vertexBuffer != 0)
+        glDeleteBuffers(1, &vertexBuffer);
+
+    vertexBuffer = 0;
+    positionAttribute.reset();
+    sizeUniform.reset();
+    colourUniform.reset();
+    shader.reset();
+}
+
+void OpenGLDisplayRenderer::renderOpenGL()
+{
+    using namespace juce::gl;
+
+    juce::OpenGLHelpers::clear(juce::Colours::black);
+
+    if (shader == nullptr || (GLint)positionAttribute->attributeID < 0)
+        return;
+
+    const juce::ScopedLock lock(snapshotLock);
+    const auto scale = (float)context.getRenderingScale();
+    const auto toPixels = [scale](int value) { return juce::roundToInt((float)value * scale); };
+    const auto position = (GLuint)positionAttribute->attributeID;
+
+    shader->use();
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_SCISSOR_TEST);
+
+    // A batch's triangles overlap where a polyline's segments meet, and blending
+    // each one in turn would darken every joint of a translucent curve. The
+    // stencil lets each pixel take a batch's colour once: it's marked with the
+    // batch's number as it's drawn, and skipped while it carries that number.
+    glEnable(GL_STENCIL_TEST);
+    glStencilMask(0xff);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    for (auto& display : snapshot)
+    {
+        // GL's origin is the bottom left
+        const auto x = toPixels(display.area.getX());
+        const auto y = toPixels(targetBounds.getHeight() - display.area.getBottom());
+        const auto width = toPixels(display.area.getWidth());
+        const auto height = toPixels(display.area.getHeight());
+
+        glViewport(x, y, width, height);
+        glScissor(x, y, width, height);
+        juce::OpenGLHelpers::clear(display.background);
+
+        sizeUniform->set((GLfloat)display.area.getWidth(), (GLfloat)display.area.getHeight());
+        GLint mark = 0;
+
+        for (auto& batch : display.batches)
+        {
+            if (batch.triangles.empty())
+                continue;
+
+            // Start the marks again from a cleared stencil once they run out
+            if (mark == 0 || mark == 0xff)
+            {
+                glClearStencil(0);
+                glClear(GL_STENCIL_BUFFER_BIT);
+                mark = 0;
+            }
+
+            glStencilFunc(GL_NOTEQUAL, ++mark, 0xff);
+
+            colourUniform->set(batch.colour.getFloatRed(), batch.colour.getFloatGreen(),
+                               batch.colour.getFloatBlue(), batch.colour.getFloatAlpha());
+
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(batch.triangles.size() * sizeof(juce::Point<float>)),
+                         batch.triangles.data(), GL_STREAM_DRAW);
+            glEnableVertexAttribArray(position);
+            glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, sizeof(juce::Point<float>), nullptr);
+            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)batch.triangles.size());
+            glDisableVertexAttribArray(position);
+        }
+    }
+
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Give the component painting that follows the whole surface back
+    glViewport(0, 0, toPixels(targetBounds.getWidth()), toPixels(targetBounds.getHeight()));
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "GeometryDisplay.h"
+
+// Optional GPU rendering for the editor.
+//
+// Attaches an OpenGLContext to the editor so JUCE composites the whole
+// component tree on the GPU, and draws the GeometryDisplays' curves, echo
+// trains, meters and scope with a small flat-colour shader instead of
+// rasterising them on the message thread. Each display's geometry is copied
+// into a snapshot on the message thread whenever it changes; the GL thread
+// only ever reads the snapshot.
+//
+// If the context doesn't come up, or the shader won't compile, the renderer
+// detaches and the displays go back to painting themselves in software.
+class OpenGLDisplayRenderer : private juce::OpenGLRenderer,
+                              private juce::ComponentListener,
+                              private juce::AsyncUpdater,
+                              private juce::Timer
+{
+public:
+    explicit OpenGLDisplayRenderer(juce::Component& targetComponent);
+    ~OpenGLDisplayRenderer() override;
+
+    // Registers a display inside the target; call before enabling
+    void addDisplay(GeometryDisplay& display);
+
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const noexcept { return enabled; }
+
+    // True once the GL context is up and drawing the displays
+    bool isActive() const noexcept { return active; }
+
+    // Keeps the target's own paint() off the areas the GPU draws
+    void excludeDisplays(juce::Graphics& g) const;
+
+private:
+    struct DisplaySnapshot
+    {
+        juce::Rectangle<int> area;   // in target coordinates
+        juce::Colour background;
+        std::vector<DisplayGeometry::Batch> batches;
+    };
+
+    void newOpenGLContextCreated() override;
+    void renderOpenGL() override;
+    void openGLContextClosing() override;
+
+    void componentMovedOrResized(juce::Component&, bool, bool) override;
+    void componentVisibilityChanged(juce::Component&) override;
+
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+
+    void setActive(bool shouldBeActive);
+    void updateSnapshot();
+
+    juce::Component& target;
+    juce::OpenGLContext context;
+    std::vector<GeometryDisplay*> displays;
+    bool enabled = false;
+    bool active = false;
+
+    // Set on the GL thread, acted on by handleAsyncUpdate()
+    std::atomic<bool> contextCreated { false }, contextFailed { false };
+
+    juce::CriticalSection snapshotLock;
+    std::vector<DisplaySnapshot> snapshot;
+    juce::Rectangle<int> targetBounds;
+
+    // GL thread only
+    std::unique_ptr<juce::OpenGLShaderProgram> shader;
+    std::unique_ptr<juce::OpenGLShaderProgram::Attribute> positionAttribute;
+    std::unique_ptr<juce::OpenGLShaderProgram::Uniform> sizeUniform, colourUniform;
+    juce::gl::GLuint vertexBuffer = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OpenGLDisplayRenderer)
+};
\ No newline at end of file
@@ -5,26 +5,165 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
     // Set up toggle buttons
+    compressorButton.setButtonText("Comp");
+    compressorButton.setToggleState(false, juce::dontSendNotification);
+    compressorButton.onClick = [this]() { selectPanel(Panel::compressor); };
+    addAndMakeVisible(compressorButton);
+
     distortionButton.setButtonText("Distortion");
     distortionButton.setToggleState(true, juce::dontSendNotification);
-    distortionButton.onClick = [this]() {
-        distortionButton.setToggleState(true, juce::dontSendNotification);
-        delayButton.setToggleState(false, juce::dontSendNotification);
-        showDistortionPanel(true);
-        showDelayPanel(false);
-        };
+    distortionButton.onClick = [this]() { selectPanel(Panel::distortion); };
     addAndMakeVisible(distortionButton);
 
+    convolutionButton.setButtonText("IR");
+    convolutionButton.setToggleState(false, juce::dontSendNotification);
+    convolutionButton.onClick = [this]() { selectPanel(Panel::convolution); };
+    addAndMakeVisible(convolutionButton);
+
+    modulationButton.setButtonText("Mod");
+    modulationButton.setToggleState(false, juce::dontSendNotification);
+    modulationButton.onClick = [this]() { selectPanel(Panel::modulation); };
+    addAndMakeVisible(modulationButton);
+
     delayButton.setButtonText("Delay");
     delayButton.setToggleState(false, juce::dontSendNotification);
-    delayButton.onClick = [this]() {
-        distortionButton.setToggleState(false, juce::dontSendNotification);
-        delayButton.setToggleState(true, juce::dontSendNotification);
-        showDistortionPanel(false);
-        showDelayPanel(true);
-        };
+    delayButton.onClick = [this]() { selectPanel(Panel::delay); };
     addAndMakeVisible(delayButton);
 
+    reverbButton.setButtonText("Reverb");
+    reverbButton.setToggleState(false, juce::dontSendNotification);
+    reverbButton.onClick = [this]() { selectPanel(Panel::reverb); };
+    addAndMakeVisible(reverbButton);
+
+    spectrumButton.setButtonText("Spectrum");
+    spectrumButton.setToggleState(false, juce::dontSendNotification);
+    spectrumButton.onClick = [this]() { selectPanel(Panel::spectrum); };
+    addAndMakeVisible(spectrumButton);
+
+    // Set up compressor panel
+    addChildComponent(compressorPanel);
+    compressorPanel.setVisible(false);
+
+    // Add compressor components to the panel
+    compressorPanel.addChildComponent(compressorEnabledButton);
+    compressorPanel.addChildComponent(compressorThresholdSlider);
+    compressorPanel.addChildComponent(compressorThresholdLabel);
+    compressorPanel.addChildComponent(compressorRatioSlider);
+    compressorPanel.addChildComponent(compressorRatioLabel);
+    compressorPanel.addChildComponent(compressorAttackSlider);
+    compressorPanel.addChildComponent(compressorAttackLabel);
+    compressorPanel.addChildComponent(compressorReleaseSlider);
+    compressorPanel.addChildComponent(compressorReleaseLabel);
+    compressorPanel.addChildComponent(compressorLookaheadSlider);
+    compressorPanel.addChildComponent(compressorLookaheadLabel);
+    compressorPanel.addChildComponent(compressorMakeupSlider);
+    compressorPanel.addChildComponent(compressorMakeupLabel);
+    compressorPanel.addChildComponent(compressorDisplay);
+
+    // Configure compressor components
+    compressorEnabledButton.setButtonText("On");
+    compressorEnabledButton.setVisible(true);
+
+    compressorThresholdSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorThresholdSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorThresholdSlider.setTextValueSuffix(" dB");
+    compressorThresholdSlider.setVisible(true);
+
+    compressorThresholdLabel.setText("Threshold", juce::dontSendNotification);
+    compressorThresholdLabel.setJustificationType(juce::Justification::centred);
+    compressorThresholdLabel.setVisible(true);
+
+    compressorRatioSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorRatioSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorRatioSlider.setTextValueSuffix(":1");
+    compressorRatioSlider.setVisible(true);
+
+    compressorRatioLabel.setText("Ratio", juce::dontSendNotification);
+    compressorRatioLabel.setJustificationType(juce::Justification::centred);
+    compressorRatioLabel.setVisible(true);
+
+    compressorAttackSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorAttackSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorAttackSlider.setTextValueSuffix(" ms");
+    compressorAttackSlider.setVisible(true);
+
+    compressorAttackLabel.setText("Attack", juce::dontSendNotification);
+    compressorAttackLabel.setJustificationType(juce::Justification::centred);
+    compressorAttackLabel.setVisible(true);
+
+    compressorReleaseSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorReleaseSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorReleaseSlider.setTextValueSuffix(" ms");
+    compressorReleaseSlider.setVisible(true);
+
+    compressorReleaseLabel.setText("Release", juce::dontSendNotification);
+    compressorReleaseLabel.setJustificationType(juce::Justification::centred);
+    compressorReleaseLabel.setVisible(true);
+
+    compressorLookaheadSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorLookaheadSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorLookaheadSlider.setTextValueSuffix(" ms");
+    compressorLookaheadSlider.setVisible(true);
+
+    compressorLookaheadLabel.setText("Look-ahead", juce::dontSendNotification);
+    compressorLookaheadLabel.setJustificationType(juce::Justification::centred);
+    compressorLookaheadLabel.setVisible(true);
+
+    compressorMakeupSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    compressorMakeupSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    compressorMakeupSlider.setTextValueSuffix(" dB");
+    compressorMakeupSlider.setVisible(true);
+
+    compressorMakeupLabel.setText("Makeup", juce::dontSendNotification);
+    compressorMakeupLabel.setJustificationType(juce::Justification::centred);
+    compressorMakeupLabel.setVisible(true);
+
+    compressorDisplay.setVisible(true);
+
+    // Connect compressor parameters
+    compressorEnabledAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getParameters(), "compressorEnabled", compressorEnabledButton);
+
+    compressorThresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorThreshold", compressorThresholdSlider);
+
+    compressorRatioAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorRatio", compressorRatioSlider);
+
+    compressorAttackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorAttack", compressorAttackSlider);
+
+    compressorReleaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorRelease", compressorReleaseSlider);
+
+    compressorLookaheadAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorLookahead", compressorLookaheadSlider);
+
+    compressorMakeupAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "compressorMakeup", compressorMakeupSlider);
+
+    // Set up compressor display; the gain reduction follows on the timer
+    compressorEnabledButton.onClick = [this]() {
+        compressorDisplay.setEnabled(compressorEnabledButton.getToggleState());
+        };
+
+    compressorThresholdSlider.onValueChange = [this]() {
+        compressorDisplay.setThreshold((float)compressorThresholdSlider.getValue());
+        };
+
+    compressorRatioSlider.onValueChange = [this]() {
+        compressorDisplay.setRatio((float)compressorRatioSlider.getValue());
+        };
+
+    compressorMakeupSlider.onValueChange = [this]() {
+        compressorDisplay.setMakeup((float)compressorMakeupSlider.getValue());
+        };
+
+    compressorDisplay.setEnabled(compressorEnabledButton.getToggleState());
+    compressorDisplay.setThreshold((float)compressorThresholdSlider.getValue());
+    compressorDisplay.setRatio((float)compressorRatioSlider.getValue());
+    compressorDisplay.setMakeup((float)compressorMakeupSlider.getValue());
+
     // Set up distortion panel
     addChildComponent(distortionPanel);
     distortionPanel.setVisible(true);
@@ -36,6 +175,10 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     distortionPanel.addChildComponent(distortionLabel);
     distortionPanel.addChildComponent(distortionTypeComboBox);
     distortionPanel.addChildComponent(distortionTypeLabel);
+    distortionPanel.addChildComponent(oversamplingComboBox);
+    distortionPanel.addChildComponent(oversamplingLabel);
+    distortionPanel.addChildComponent(antiAliasingComboBox);
+    distortionPanel.addChildComponent(antiAliasingLabel);
     distortionPanel.addChildComponent(waveShapeDisplay);
 
     // Configure distortion components
@@ -67,6 +210,25 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     distortionTypeLabel.setJustificationType(juce::Justification::centred);
     distortionTypeLabel.setVisible(true);
 
+    oversamplingComboBox.addItem("1x", 1);
+    oversamplingComboBox.addItem("2x", 2);
+    oversamplingComboBox.addItem("4x", 3);
+    oversamplingComboBox.addItem("8x", 4);
+    oversamplingComboBox.setVisible(true);
+
+    oversamplingLabel.setText("Oversampling", juce::dontSendNotification);
+    oversamplingLabel.setJustificationType(juce::Justification::centred);
+    oversamplingLabel.setVisible(true);
+
+    antiAliasingComboBox.addItem("Off", 1);
+    antiAliasingComboBox.addItem("ADAA 1st Order", 2);
+    antiAliasingComboBox.addItem("ADAA 2nd Order", 3);
+    antiAliasingComboBox.setVisible(true);
+
+    antiAliasingLabel.setText("Anti-Alias", juce::dontSendNotification);
+    antiAliasingLabel.setJustificationType(juce::Justification::centred);
+    antiAliasingLabel.setVisible(true);
+
     waveShapeDisplay.setVisible(true);
 
     // Connect distortion parameters
@@ -79,6 +241,12 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     distortionTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getParameters(), "distortionType", distortionTypeComboBox);
 
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "oversampling", oversamplingComboBox);
+
+    antiAliasingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "antiAliasing", antiAliasingComboBox);
+
     // Set up distortion display
     distortionSlider.onValueChange = [this]() {
         waveShapeDisplay.setAmount(distortionSlider.getValue());
@@ -91,6 +259,150 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     waveShapeDisplay.setAmount(distortionSlider.getValue());
     waveShapeDisplay.setDistortionType(distortionTypeComboBox.getSelectedId() - 1);
 
+    // Set up impulse response panel
+    addChildComponent(convolutionPanel);
+    convolutionPanel.setVisible(false);
+
+    // Add impulse response components to the panel
+    convolutionPanel.addChildComponent(loadImpulseResponseButton);
+    convolutionPanel.addChildComponent(clearImpulseResponseButton);
+    convolutionPanel.addChildComponent(convolutionMixSlider);
+    convolutionPanel.addChildComponent(convolutionMixLabel);
+    convolutionPanel.addChildComponent(impulseResponseDisplay);
+
+    // Configure impulse response components
+    loadImpulseResponseButton.setButtonText("Load IR...");
+    loadImpulseResponseButton.onClick = [this]() { chooseImpulseResponse(); };
+    loadImpulseResponseButton.setVisible(true);
+
+    clearImpulseResponseButton.setButtonText("Clear");
+    clearImpulseResponseButton.onClick = [this]() { audioProcessor.clearImpulseResponse(); };
+    clearImpulseResponseButton.setEnabled(false);
+    clearImpulseResponseButton.setVisible(true);
+
+    convolutionMixSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    convolutionMixSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    convolutionMixSlider.setVisible(true);
+
+    convolutionMixLabel.setText("Mix", juce::dontSendNotification);
+    convolutionMixLabel.setJustificationType(juce::Justification::centred);
+    convolutionMixLabel.setVisible(true);
+
+    impulseResponseDisplay.setVisible(true);
+
+    // Connect impulse response parameters
+    convolutionMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "convolutionMix", convolutionMixSlider);
+
+    // Set up impulse response display. Loads finish in the background, so the
+    // timer picks up the loader's progress.
+    convolutionMixSlider.onValueChange = [this]() {
+        impulseResponseDisplay.setMix((float)convolutionMixSlider.getValue());
+        };
+
+    impulseResponseDisplay.setMix((float)convolutionMixSlider.getValue());
+    updateImpulseResponseStatus();
+
+    // Set up modulation panel
+    addChildComponent(modulationPanel);
+    modulationPanel.setVisible(false);
+
+    // Add modulation components to the panel
+    modulationPanel.addChildComponent(modulationModeComboBox);
+    modulationPanel.addChildComponent(modulationModeLabel);
+    modulationPanel.addChildComponent(modulationRateSlider);
+    modulationPanel.addChildComponent(modulationRateLabel);
+    modulationPanel.addChildComponent(modulationDepthSlider);
+    modulationPanel.addChildComponent(modulationDepthLabel);
+    modulationPanel.addChildComponent(modulationFeedbackSlider);
+    modulationPanel.addChildComponent(modulationFeedbackLabel);
+    modulationPanel.addChildComponent(modulationMixSlider);
+    modulationPanel.addChildComponent(modulationMixLabel);
+    modulationPanel.addChildComponent(modulationDisplay);
+
+    // Configure modulation components
+    modulationModeComboBox.addItem("Chorus", 1);
+    modulationModeComboBox.addItem("Flanger", 2);
+    modulationModeComboBox.addItem("Phaser", 3);
+    modulationModeComboBox.setVisible(true);
+
+    modulationModeLabel.setText("Mode", juce::dontSendNotification);
+    modulationModeLabel.setJustificationType(juce::Justification::centred);
+    modulationModeLabel.setVisible(true);
+
+    modulationRateSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    modulationRateSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    modulationRateSlider.setTextValueSuffix(" Hz");
+    modulationRateSlider.setVisible(true);
+
+    modulationRateLabel.setText("Rate", juce::dontSendNotification);
+    modulationRateLabel.setJustificationType(juce::Justification::centred);
+    modulationRateLabel.setVisible(true);
+
+    modulationDepthSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    modulationDepthSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    modulationDepthSlider.setVisible(true);
+
+    modulationDepthLabel.setText("Depth", juce::dontSendNotification);
+    modulationDepthLabel.setJustificationType(juce::Justification::centred);
+    modulationDepthLabel.setVisible(true);
+
+    modulationFeedbackSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    modulationFeedbackSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    modulationFeedbackSlider.setVisible(true);
+
+    modulationFeedbackLabel.setText("Feedback", juce::dontSendNotification);
+    modulationFeedbackLabel.setJustificationType(juce::Justification::centred);
+    modulationFeedbackLabel.setVisible(true);
+
+    modulationMixSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    modulationMixSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    modulationMixSlider.setVisible(true);
+
+    modulationMixLabel.setText("Mix", juce::dontSendNotification);
+    modulationMixLabel.setJustificationType(juce::Justification::centred);
+    modulationMixLabel.setVisible(true);
+
+    modulationDisplay.setVisible(true);
+
+    // Connect modulation parameters
+    modulationModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "modulationMode", modulationModeComboBox);
+
+    modulationRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "modulationRate", modulationRateSlider);
+
+    modulationDepthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "modulationDepth", modulationDepthSlider);
+
+    modulationFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "modulationFeedback", modulationFeedbackSlider);
+
+    modulationMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "modulationMix", modulationMixSlider);
+
+    // Set up modulation display
+    modulationModeComboBox.onChange = [this]() {
+        modulationDisplay.setMode(modulationModeComboBox.getSelectedId() - 1);
+        };
+
+    modulationRateSlider.onValueChange = [this]() {
+        modulationDisplay.setRate((float)modulationRateSlider.getValue());
+        };
+
+    modulationDepthSlider.onValueChange = [this]() {
+        modulationDisplay.setDepth((float)modulationDepthSlider.getValue());
+        };
+
+    modulationMixSlider.onValueChange = [this]() {
+        modulationDisplay.setMix((float)modulationMixSlider.getValue());
+        };
+
+    modulationDisplay.setMode(modulationModeComboBox.getSelectedId() - 1);
+    modulationDisplay.setRate((float)modulationRateSlider.getValue());
+    modulationDisplay.setDepth((float)modulationDepthSlider.getValue());
+    modulationDisplay.setMix((float)modulationMixSlider.getValue());
+
     // Set up delay panel
     addChildComponent(delayPanel);
     delayPanel.setVisible(false);
@@ -102,6 +414,11 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     delayPanel.addChildComponent(feedbackLabel);
     delayPanel.addChildComponent(mixSlider);
     delayPanel.addChildComponent(mixLabel);
+    delayPanel.addChildComponent(interpolationComboBox);
+    delayPanel.addChildComponent(interpolationLabel);
+    delayPanel.addChildComponent(delaySyncButton);
+    delayPanel.addChildComponent(delayDivisionComboBox);
+    delayPanel.addChildComponent(delayDivisionLabel);
     delayPanel.addChildComponent(delayDisplay);
 
     // Configure delay components
@@ -129,6 +446,25 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     mixLabel.setJustificationType(juce::Justification::centred);
     mixLabel.setVisible(true);
 
+    interpolationComboBox.addItem("Linear", 1);
+    interpolationComboBox.addItem("Lagrange", 2);
+    interpolationComboBox.addItem("Allpass", 3);
+    interpolationComboBox.setVisible(true);
+
+    interpolationLabel.setText("Interpolation", juce::dontSendNotification);
+    interpolationLabel.setJustificationType(juce::Justification::centred);
+    interpolationLabel.setVisible(true);
+
+    delaySyncButton.setButtonText("Sync");
+    delaySyncButton.setVisible(true);
+
+    delayDivisionComboBox.addItemList(TempoSync::getDivisionNames(), 1);
+    delayDivisionComboBox.setVisible(true);
+
+    delayDivisionLabel.setText("Division", juce::dontSendNotification);
+    delayDivisionLabel.setJustificationType(juce::Justification::centred);
+    delayDivisionLabel.setVisible(true);
+
     delayDisplay.setVisible(true);
 
     // Connect delay parameters
@@ -141,6 +477,22 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     mixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getParameters(), "delayMix", mixSlider);
 
+    interpolationAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "delayInterpolation", interpolationComboBox);
+
+    delaySyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getParameters(), "delaySync", delaySyncButton);
+
+    delayDivisionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "delayDivision", delayDivisionComboBox);
+
+    // The free time knob does nothing while synced
+    delaySyncButton.onClick = [this]() {
+        delayTimeSlider.setEnabled(!delaySyncButton.getToggleState());
+        };
+
+    delayTimeSlider.setEnabled(!delaySyncButton.getToggleState());
+
     // Set up delay display
     delayTimeSlider.onValueChange = [this]() {
         delayDisplay.setDelayTime(delayTimeSlider.getValue());
@@ -158,16 +510,200 @@ _3ff3ctsAudioProcessorEditor::_3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcesso
     delayDisplay.setFeedback(feedbackSlider.getValue());
     delayDisplay.setMix(mixSlider.getValue());
 
+    // Set up reverb panel
+    addChildComponent(reverbPanel);
+    reverbPanel.setVisible(false);
+
+    // Add reverb components to the panel
+    reverbPanel.addChildComponent(reverbSizeSlider);
+    reverbPanel.addChildComponent(reverbSizeLabel);
+    reverbPanel.addChildComponent(reverbDecaySlider);
+    reverbPanel.addChildComponent(reverbDecayLabel);
+    reverbPanel.addChildComponent(reverbDampingSlider);
+    reverbPanel.addChildComponent(reverbDampingLabel);
+    reverbPanel.addChildComponent(reverbMixSlider);
+    reverbPanel.addChildComponent(reverbMixLabel);
+    reverbPanel.addChildComponent(reverbDisplay);
+
+    // Configure reverb components
+    reverbSizeSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    reverbSizeSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    reverbSizeSlider.setVisible(true);
+
+    reverbSizeLabel.setText("Size", juce::dontSendNotification);
+    reverbSizeLabel.setJustificationType(juce::Justification::centred);
+    reverbSizeLabel.setVisible(true);
+
+    reverbDecaySlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    reverbDecaySlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    reverbDecaySlider.setTextValueSuffix(" s");
+    reverbDecaySlider.setVisible(true);
+
+    reverbDecayLabel.setText("Decay", juce::dontSendNotification);
+    reverbDecayLabel.setJustificationType(juce::Justification::centred);
+    reverbDecayLabel.setVisible(true);
+
+    reverbDampingSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    reverbDampingSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    reverbDampingSlider.setVisible(true);
+
+    reverbDampingLabel.setText("Damping", juce::dontSendNotification);
+    reverbDampingLabel.setJustificationType(juce::Justification::centred);
+    reverbDampingLabel.setVisible(true);
+
+    reverbMixSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryHorizontalVerticalDrag);
+    reverbMixSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 80, 20);
+    reverbMixSlider.setVisible(true);
+
+    reverbMixLabel.setText("Mix", juce::dontSendNotification);
+    reverbMixLabel.setJustificationType(juce::Justification::centred);
+    reverbMixLabel.setVisible(true);
+
+    reverbDisplay.setVisible(true);
+
+    // Connect reverb parameters
+    reverbSizeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "reverbSize", reverbSizeSlider);
+
+    reverbDecayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "reverbDecay", reverbDecaySlider);
+
+    reverbDampingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "reverbDamping", reverbDampingSlider);
+
+    reverbMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getParameters(), "reverbMix", reverbMixSlider);
+
+    // Set up reverb display
+    reverbSizeSlider.onValueChange = [this]() {
+        reverbDisplay.setRoomSize((float)reverbSizeSlider.getValue());
+        };
+
+    reverbDecaySlider.onValueChange = [this]() {
+        reverbDisplay.setDecay((float)reverbDecaySlider.getValue());
+        };
+
+    reverbDampingSlider.onValueChange = [this]() {
+        reverbDisplay.setDamping((float)reverbDampingSlider.getValue());
+        };
+
+    reverbMixSlider.onValueChange = [this]() {
+        reverbDisplay.setMix((float)reverbMixSlider.getValue());
+        };
+
+    reverbDisplay.setRoomSize((float)reverbSizeSlider.getValue());
+    reverbDisplay.setDecay((float)reverbDecaySlider.getValue());
+    reverbDisplay.setDamping((float)reverbDampingSlider.getValue());
+    reverbDisplay.setMix((float)reverbMixSlider.getValue());
+
+    // Set up spectrum panel
+    addChildComponent(spectrumPanel);
+    spectrumPanel.setVisible(false);
+    spectrumPanel.addChildComponent(spectrumDisplay);
+    spectrumDisplay.setVisible(true);
+
+    // Live signal strip under the panels. The processor only meters while an
+    // editor is open, and the timer picks up whatever arrived since the last tick.
+    addAndMakeVisible(signalMonitor);
+    meterFrames.resize(MeterFeed::frameCapacity);
+    scopePoints.resize(MeterFeed::scopeCapacity);
+    audioProcessor.getMeterFeed().setActive(true);
+    startTimerHz(meterRefreshHz);
+
+    // GPU rendering of the displays. The choice is saved with the plugin state
+    // but isn't a parameter; without usable OpenGL the displays stay in software.
+    gpuButton.setButtonText("GPU");
+    gpuButton.setToggleState(audioProcessor.getParameters().state.getProperty("gpuRendering", true),
+                             juce::dontSendNotification);
+    gpuButton.onClick = [this]() {
+        audioProcessor.getParameters().state.setProperty("gpuRendering", gpuButton.getToggleState(), nullptr);
+        displayRenderer.setEnabled(gpuButton.getToggleState());
+        };
+    addAndMakeVisible(gpuButton);
+
+    // Effect order, on the left of the title
+    chainOrderComboBox.addItemList(_3ff3ctsAudioProcessor::getChainOrderNames(), 1);
+    chainOrderComboBox.setTooltip("Order of the effects");
+    addAndMakeVisible(chainOrderComboBox);
+
+    chainOrderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getParameters(), "chainOrder", chainOrderComboBox);
+
+    displayRenderer.addDisplay(compressorDisplay);
+    displayRenderer.addDisplay(waveShapeDisplay);
+    displayRenderer.addDisplay(impulseResponseDisplay);
+    displayRenderer.addDisplay(modulationDisplay);
+    displayRenderer.addDisplay(delayDisplay);
+    displayRenderer.addDisplay(reverbDisplay);
+    displayRenderer.addDisplay(signalMonitor);
+    displayRenderer.addDisplay(spectrumDisplay);
+
     // Set window size
-    setSize(500, 500);
+    setSize(600, 580);
+    displayRenderer.setEnabled(gpuButton.getToggleState());
 }
 
 _3ff3ctsAudioProcessorEditor::~_3ff3ctsAudioProcessorEditor()
 {
+    displayRenderer.setEnabled(false);
+    stopTimer();
+    audioProcessor.getMeterFeed().setActive(false);
+    audioProcessor.getSpectrumAnalyser().setActive(false);
+}
+
+void _3ff3ctsAudioProcessorEditor::timerCallback()
+{
+    auto& feed = audioProcessor.getMeterFeed();
+    const auto numFrames = feed.readFrames(meterFrames.data(), (int)meterFrames.size());
+    const auto numPoints = feed.readScope(scopePoints.data(), (int)scopePoints.size());
+
+    signalMonitor.update(meterFrames.data(), numFrames, scopePoints.data(), numPoints);
+    compressorDisplay.setGainReduction(audioProcessor.getCompressorGainReductionDb());
+
+    auto& analyser = audioProcessor.getSpectrumAnalyser();
+
+    if (analyser.isActive() && analyser.getLatest(spectra))
+        spectrumDisplay.update(spectra, analyser);
+
+    updateImpulseResponseStatus();
+}
+
+void _3ff3ctsAudioProcessorEditor::updateImpulseResponseStatus()
+{
+    // Only redraw when a load starts, finishes or fails
+    const auto status = audioProcessor.getImpulseResponseStatus();
+
+    if (status.state == shownImpulseResponseStatus.state
+        && status.file == shownImpulseResponseStatus.file
+        && status.response == shownImpulseResponseStatus.response)
+        return;
+
+    shownImpulseResponseStatus = status;
+    impulseResponseDisplay.setStatus(status);
+    clearImpulseResponseButton.setEnabled(status.state != ConvolutionStage::State::empty);
+}
+
+void _3ff3ctsAudioProcessorEditor::chooseImpulseResponse()
+{
+    impulseResponseChooser = std::make_unique<juce::FileChooser>("Load an impulse response",
+                                                                 audioProcessor.getImpulseResponseStatus().file,
+                                                                 "*.wav;*.aif;*.aiff;*.flac");
+
+    impulseResponseChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                        [this](const juce::FileChooser& chooser) {
+                                            const auto file = chooser.getResult();
+
+                                            if (file != juce::File())
+                                                audioProcessor.loadImpulseResponse(file);
+                                        });
 }
 
 void _3ff3ctsAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    // The GPU fills the displays itself when it's drawing them
+    if (displayRenderer.isActive())
+        displayRenderer.excludeDisplays(g);
+
     // Fill background
     g.fillAll(juce::Colours::darkgrey);
 
@@ -181,18 +717,71 @@ void _3ff3ctsAudioProcessorEditor::resized()
 {
     auto area = getLocalBounds().reduced(20);
 
-    // Position title
+    // Position title, with the effect order on the left and the GPU switch on the right
     auto titleArea = area.removeFromTop(30);
+    chainOrderComboBox.setBounds(titleArea.removeFromLeft(190).reduced(5, 3));
+    gpuButton.setBounds(titleArea.removeFromRight(70));
 
     // Position toggle buttons at the top
     auto toggleArea = area.removeFromTop(30);
-    distortionButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 2).reduced(5, 0));
-    delayButton.setBounds(toggleArea.reduced(5, 0));
+    compressorButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 7).reduced(5, 0));
+    distortionButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 6).reduced(5, 0));
+    convolutionButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 5).reduced(5, 0));
+    modulationButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 4).reduced(5, 0));
+    delayButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 3).reduced(5, 0));
+    reverbButton.setBounds(toggleArea.removeFromLeft(toggleArea.getWidth() / 2).reduced(5, 0));
+    spectrumButton.setBounds(toggleArea.reduced(5, 0));
+
+    // Signal monitor along the bottom, shared by both panels
+    signalMonitor.setBounds(area.removeFromBottom(70).reduced(5, 0));
+    area.removeFromBottom(10);
 
     // Position panels (they occupy the same space - only one visible at a time)
     auto contentArea = area;
+    compressorPanel.setBounds(contentArea);
     distortionPanel.setBounds(contentArea);
+    convolutionPanel.setBounds(contentArea);
+    modulationPanel.setBounds(contentArea);
     delayPanel.setBounds(contentArea);
+    reverbPanel.setBounds(contentArea);
+    spectrumPanel.setBounds(contentArea);
+
+    // Layout for compressor panel
+    auto compressorArea = contentArea.reduced(5);
+    compressorDisplay.setBounds(compressorArea.removeFromTop(150));
+    compressorArea.removeFromTop(10);
+
+    // Curve controls in four columns, the rest in three below them
+    auto compressorCurveArea = compressorArea.removeFromTop(120);
+    auto thresholdArea = compressorCurveArea.removeFromLeft(compressorCurveArea.getWidth() / 4);
+    auto ratioArea = compressorCurveArea.removeFromLeft(compressorCurveArea.getWidth() / 3);
+    auto attackArea = compressorCurveArea.removeFromLeft(compressorCurveArea.getWidth() / 2);
+    auto releaseArea = compressorCurveArea;
+
+    compressorThresholdLabel.setBounds(thresholdArea.removeFromTop(20));
+    compressorThresholdSlider.setBounds(thresholdArea.removeFromTop(100));
+
+    compressorRatioLabel.setBounds(ratioArea.removeFromTop(20));
+    compressorRatioSlider.setBounds(ratioArea.removeFromTop(100));
+
+    compressorAttackLabel.setBounds(attackArea.removeFromTop(20));
+    compressorAttackSlider.setBounds(attackArea.removeFromTop(100));
+
+    compressorReleaseLabel.setBounds(releaseArea.removeFromTop(20));
+    compressorReleaseSlider.setBounds(releaseArea.removeFromTop(100));
+
+    auto enabledArea = compressorArea.removeFromLeft(compressorArea.getWidth() / 3);
+    auto lookaheadArea = compressorArea.removeFromLeft(compressorArea.getWidth() / 2);
+    auto makeupArea = compressorArea;
+
+    enabledArea.removeFromTop(20);
+    compressorEnabledButton.setBounds(enabledArea.getCentreX() - 40, enabledArea.getY(), 80, 25);
+
+    compressorLookaheadLabel.setBounds(lookaheadArea.removeFromTop(20));
+    compressorLookaheadSlider.setBounds(lookaheadArea.removeFromTop(90));
+
+    compressorMakeupLabel.setBounds(makeupArea.removeFromTop(20));
+    compressorMakeupSlider.setBounds(makeupArea.removeFromTop(90));
 
     // Layout for distortion panel
     auto distortionArea = contentArea.reduced(5);
@@ -230,6 +819,115 @@ void _3ff3ctsAudioProcessorEditor::resized()
         comboHeight
     );
 
+    // Oversampling and anti-aliasing sit below the gain controls, mirroring the type selector
+    auto qualityArea = leftArea.removeFromBottom(50);
+    auto oversamplingArea = qualityArea.removeFromLeft(qualityArea.getWidth() / 2);
+    auto antiAliasingArea = qualityArea;
+    oversamplingLabel.setBounds(oversamplingArea.removeFromTop(20));
+    antiAliasingLabel.setBounds(antiAliasingArea.removeFromTop(20));
+
+    int qualityComboWidth = 100;
+    oversamplingComboBox.setBounds(
+        oversamplingArea.getCentreX() - qualityComboWidth / 2,
+        oversamplingArea.getY(),
+        qualityComboWidth,
+        comboHeight
+    );
+    antiAliasingComboBox.setBounds(
+        antiAliasingArea.getCentreX() - qualityComboWidth / 2,
+        antiAliasingArea.getY(),
+        qualityComboWidth,
+        comboHeight
+    );
+
+    // Layout for impulse response panel
+    auto convolutionArea = contentArea.reduced(5);
+    impulseResponseDisplay.setBounds(convolutionArea.removeFromTop(150));
+    convolutionArea.removeFromTop(10);
+
+    // Load and clear on the left, mix knob on the right
+    auto fileArea = convolutionArea.removeFromLeft(convolutionArea.getWidth() / 2);
+    auto convolutionMixArea = convolutionArea;
+
+    fileArea.removeFromTop(20);
+    int fileButtonWidth = 120;
+    loadImpulseResponseButton.setBounds(
+        fileArea.getCentreX() - fileButtonWidth / 2,
+        fileArea.getY(),
+        fileButtonWidth,
+        comboHeight
+    );
+    clearImpulseResponseButton.setBounds(
+        fileArea.getCentreX() - fileButtonWidth / 2,
+        fileArea.getY() + comboHeight + 10,
+        fileButtonWidth,
+        comboHeight
+    );
+
+    convolutionMixLabel.setBounds(convolutionMixArea.removeFromTop(20));
+    convolutionMixSlider.setBounds(convolutionMixArea.removeFromTop(100));
+
+    // Layout for modulation panel
+    auto modulationArea = contentArea.reduced(5);
+    modulationDisplay.setBounds(modulationArea.removeFromTop(150));
+    modulationArea.removeFromTop(10);
+
+    // Mode selector along the bottom
+    auto modulationModeArea = modulationArea.removeFromBottom(50);
+    modulationModeLabel.setBounds(modulationModeArea.removeFromTop(20));
+    modulationModeComboBox.setBounds(
+        modulationModeArea.getCentreX() - comboWidth / 2,
+        modulationModeArea.getY(),
+        comboWidth,
+        comboHeight
+    );
+
+    // Four columns for the knobs
+    auto modulationControlsArea = modulationArea;
+    auto rateArea = modulationControlsArea.removeFromLeft(modulationControlsArea.getWidth() / 4);
+    auto depthArea = modulationControlsArea.removeFromLeft(modulationControlsArea.getWidth() / 3);
+    auto modulationFeedbackArea = modulationControlsArea.removeFromLeft(modulationControlsArea.getWidth() / 2);
+    auto modulationMixArea = modulationControlsArea;
+
+    modulationRateLabel.setBounds(rateArea.removeFromTop(20));
+    modulationRateSlider.setBounds(rateArea.removeFromTop(100));
+
+    modulationDepthLabel.setBounds(depthArea.removeFromTop(20));
+    modulationDepthSlider.setBounds(depthArea.removeFromTop(100));
+
+    modulationFeedbackLabel.setBounds(modulationFeedbackArea.removeFromTop(20));
+    modulationFeedbackSlider.setBounds(modulationFeedbackArea.removeFromTop(100));
+
+    modulationMixLabel.setBounds(modulationMixArea.removeFromTop(20));
+    modulationMixSlider.setBounds(modulationMixArea.removeFromTop(100));
+
+    // Layout for reverb panel
+    auto reverbArea = contentArea.reduced(5);
+    reverbDisplay.setBounds(reverbArea.removeFromTop(150));
+    reverbArea.removeFromTop(10);
+
+    // Four columns for the controls
+    auto reverbControlsArea = reverbArea;
+    auto sizeArea = reverbControlsArea.removeFromLeft(reverbControlsArea.getWidth() / 4);
+    auto decayArea = reverbControlsArea.removeFromLeft(reverbControlsArea.getWidth() / 3);
+    auto dampingArea = reverbControlsArea.removeFromLeft(reverbControlsArea.getWidth() / 2);
+    auto reverbMixArea = reverbControlsArea;
+
+    reverbSizeLabel.setBounds(sizeArea.removeFromTop(20));
+    reverbSizeSlider.setBounds(sizeArea.removeFromTop(100));
+
+    reverbDecayLabel.setBounds(decayArea.removeFromTop(20));
+    reverbDecaySlider.setBounds(decayArea.removeFromTop(100));
+
+    reverbDampingLabel.setBounds(dampingArea.removeFromTop(20));
+    reverbDampingSlider.setBounds(dampingArea.removeFromTop(100));
+
+    reverbMixLabel.setBounds(reverbMixArea.removeFromTop(20));
+    reverbMixSlider.setBounds(reverbMixArea.removeFromTop(100));
+
+    // The spectrum gets the whole panel
+    spectrumDisplay.setBounds(contentArea.reduced(5));
+
     // Layout for delay panel
     auto delayArea = contentArea.reduced(5);
 
@@ -237,6 +935,37 @@ void _3ff3ctsAudioProcessorEditor::resized()
     auto delayVizArea = delayArea.removeFromTop(150);
     delayDisplay.setBounds(delayVizArea);
 
+    // Sync, division and interpolation selectors along the bottom
+    auto delayOptionsArea = delayArea.removeFromBottom(50);
+    auto syncArea = delayOptionsArea.removeFromLeft(delayOptionsArea.getWidth() / 3);
+    auto divisionArea = delayOptionsArea.removeFromLeft(delayOptionsArea.getWidth() / 2);
+    auto interpolationArea = delayOptionsArea;
+
+    int optionComboWidth = 120;
+    syncArea.removeFromTop(20);
+    delaySyncButton.setBounds(
+        syncArea.getCentreX() - optionComboWidth / 2,
+        syncArea.getY(),
+        optionComboWidth,
+        comboHeight
+    );
+
+    delayDivisionLabel.setBounds(divisionArea.removeFromTop(20));
+    delayDivisionComboBox.setBounds(
+        divisionArea.getCentreX() - optionComboWidth / 2,
+        divisionArea.getY(),
+        optionComboWidth,
+        comboHeight
+    );
+
+    interpolationLabel.setBounds(interpolationArea.removeFromTop(20));
+    interpolationComboBox.setBounds(
+        interpolationArea.getCentreX() - optionComboWidth / 2,
+        interpolationArea.getY(),
+        optionComboWidth,
+        comboHeight
+    );
+
     // Controls below visualization
     auto delayControlsArea = delayArea;
 
@@ -258,6 +987,46 @@ void _3ff3ctsAudioProcessorEditor::resized()
     mixSlider.setBounds(thirdThird.removeFromTop(100));
 }
 
+void _3ff3ctsAudioProcessorEditor::selectPanel(Panel panel)
+{
+    compressorButton.setToggleState(panel == Panel::compressor, juce::dontSendNotification);
+    distortionButton.setToggleState(panel == Panel::distortion, juce::dontSendNotification);
+    convolutionButton.setToggleState(panel == Panel::convolution, juce::dontSendNotification);
+    modulationButton.setToggleState(panel == Panel::modulation, juce::dontSendNotification);
+    delayButton.setToggleState(panel == Panel::delay, juce::dontSendNotification);
+    reverbButton.setToggleState(panel == Panel::reverb, juce::dontSendNotification);
+    spectrumButton.setToggleState(panel == Panel::spectrum, juce::dontSendNotification);
+
+    showCompressorPanel(panel == Panel::compressor);
+    showDistortionPanel(panel == Panel::distortion);
+    showConvolutionPanel(panel == Panel::convolution);
+    showModulationPanel(panel == Panel::modulation);
+    showDelayPanel(panel == Panel::delay);
+    showReverbPanel(panel == Panel::reverb);
+    showSpectrumPanel(panel == Panel::spectrum);
+}
+
+void _3ff3ctsAudioProcessorEditor::showCompressorPanel(bool shouldShow)
+{
+    compressorPanel.setVisible(shouldShow);
+
+    // Make child components visible/invisible
+    compressorEnabledButton.setVisible(shouldShow);
+    compressorThresholdSlider.setVisible(shouldShow);
+    compressorThresholdLabel.setVisible(shouldShow);
+    compressorRatioSlider.setVisible(shouldShow);
+    compressorRatioLabel.setVisible(shouldShow);
+    compressorAttackSlider.setVisible(shouldShow);
+    compressorAttackLabel.setVisible(shouldShow);
+    compressorReleaseSlider.setVisible(shouldShow);
+    compressorReleaseLabel.setVisible(shouldShow);
+    compressorLookaheadSlider.setVisible(shouldShow);
+    compressorLookaheadLabel.setVisible(shouldShow);
+    compressorMakeupSlider.setVisible(shouldShow);
+    compressorMakeupLabel.setVisible(shouldShow);
+    compressorDisplay.setVisible(shouldShow);
+}
+
 void _3ff3ctsAudioProcessorEditor::showDistortionPanel(bool shouldShow)
 {
     distortionPanel.setVisible(shouldShow);
@@ -269,9 +1038,43 @@ void _3ff3ctsAudioProcessorEditor::showDistortionPanel(bool shouldShow)
     distortionLabel.setVisible(shouldShow);
     distortionTypeComboBox.setVisible(shouldShow);
     distortionTypeLabel.setVisible(shouldShow);
+    oversamplingComboBox.setVisible(shouldShow);
+    oversamplingLabel.setVisible(shouldShow);
+    antiAliasingComboBox.setVisible(shouldShow);
+    antiAliasingLabel.setVisible(shouldShow);
     waveShapeDisplay.setVisible(shouldShow);
 }
 
+void _3ff3ctsAudioProcessorEditor::showConvolutionPanel(bool shouldShow)
+{
+    convolutionPanel.setVisible(shouldShow);
+
+    // Make child components visible/invisible
+    loadImpulseResponseButton.setVisible(shouldShow);
+    clearImpulseResponseButton.setVisible(shouldShow);
+    convolutionMixSlider.setVisible(shouldShow);
+    convolutionMixLabel.setVisible(shouldShow);
+    impulseResponseDisplay.setVisible(shouldShow);
+}
+
+void _3ff3ctsAudioProcessorEditor::showModulationPanel(bool shouldShow)
+{
+    modulationPanel.setVisible(shouldShow);
+
+    // Make child components visible/invisible
+    modulationModeComboBox.setVisible(shouldShow);
+    modulationModeLabel.setVisible(shouldShow);
+    modulationRateSlider.setVisible(shouldShow);
+    modulationRateLabel.setVisible(shouldShow);
+    modulationDepthSlider.setVisible(shouldShow);
+    modulationDepthLabel.setVisible(shouldShow);
+    modulationFeedbackSlider.setVisible(shouldShow);
+    modulationFeedbackLabel.setVisible(shouldShow);
+    modulationMixSlider.setVisible(shouldShow);
+    modulationMixLabel.setVisible(shouldShow);
+    modulationDisplay.setVisible(shouldShow);
+}
+
 void _3ff3ctsAudioProcessorEditor::showDelayPanel(bool shouldShow)
 {
     delayPanel.setVisible(shouldShow);
@@ -283,5 +1086,35 @@ void _3ff3ctsAudioProcessorEditor::showDelayPanel(bool shouldShow)
     feedbackLabel.setVisible(shouldShow);
     mixSlider.setVisible(shouldShow);
     mixLabel.setVisible(shouldShow);
+    interpolationComboBox.setVisible(shouldShow);
+    interpolationLabel.setVisible(shouldShow);
+    delaySyncButton.setVisible(shouldShow);
+    delayDivisionComboBox.setVisible(shouldShow);
+    delayDivisionLabel.setVisible(shouldShow);
     delayDisplay.setVisible(shouldShow);
+}
+
+void _3ff3ctsAudioProcessorEditor::showReverbPanel(bool shouldShow)
+{
+    reverbPanel.setVisible(shouldShow);
+
+    // Make child components visible/invisible
+    reverbSizeSlider.setVisible(shouldShow);
+    reverbSizeLabel.setVisible(shouldShow);
+    reverbDecaySlider.setVisible(shouldShow);
+    reverbDecayLabel.setVisible(shouldShow);
+    reverbDampingSlider.setVisible(shouldShow);
+    reverbDampingLabel.setVisible(shouldShow);
+    reverbMixSlider.setVisible(shouldShow);
+    reverbMixLabel.setVisible(shouldShow);
+    reverbDisplay.setVisible(shouldShow);
+}
+
+void _3ff3ctsAudioProcessorEditor::showSpectrumPanel(bool shouldShow)
+{
+    spectrumPanel.setVisible(shouldShow);
+    spectrumDisplay.setVisible(shouldShow);
+
+    // The analyser thread only runs while there's a spectrum to look at
+    audioProcessor.getSpectrumAnalyser().setActive(shouldShow);
 }
\ No newline at end of file
@@ -2,62 +2,197 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "DSP/ShaperCurves.h"
+#include "GUI/GeometryDisplay.h"
+#include "GUI/OpenGLDisplayRenderer.h"
 
-// Distortion visualization component
-class WaveShapeDisplay : public juce::Component
+// Compressor visualization component.
+// Plots output level against input level through the same gain curve the
+// compressor uses (LookaheadCompressor::computeGainReduction), with a bar on
+// the right showing the gain reduction as it happens.
+class CompressorDisplay : public GeometryDisplay
+{
+public:
+    CompressorDisplay()
+        : GeometryDisplay(juce::Colours::black)
+    {
+        curvePoints.reserve(numCurvePoints);
+    }
+
+    void setThreshold(float newThreshold) { setValue(threshold, newThreshold); }
+    void setRatio(float newRatio) { setValue(ratio, newRatio); }
+    void setMakeup(float newMakeup) { setValue(makeup, newMakeup); }
+
+    void setEnabled(bool shouldBeEnabled)
+    {
+        if (shouldBeEnabled != enabled)
+        {
+            enabled = shouldBeEnabled;
+            geometryChanged();
+        }
+    }
+
+    // Called from the editor's timer; only redraws for a visible change
+    void setGainReduction(float newReduction)
+    {
+        if (std::abs(newReduction - gainReduction) >= 0.1f)
+        {
+            gainReduction = newReduction;
+            geometryChanged();
+        }
+    }
+
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        auto meterArea = bounds.removeFromRight(meterWidth);
+        bounds.removeFromRight(5.0f);
+
+        // Grid every 12 dB, plus the 1:1 line
+        for (float db = -12.0f; db > floorDb; db -= 12.0f)
+        {
+            const auto x = dbToX(db, bounds);
+            const auto y = dbToY(db, bounds);
+            geometry.addLine({ x, 0.0f }, { x, bounds.getHeight() }, 1.0f, juce::Colour(0xff303030));
+            geometry.addLine({ 0.0f, y }, { bounds.getWidth(), y }, 1.0f, juce::Colour(0xff303030));
+        }
+
+        geometry.addLine({ dbToX(floorDb, bounds), dbToY(floorDb, bounds) },
+                         { dbToX(0.0f, bounds), dbToY(0.0f, bounds) }, 1.0f, juce::Colours::darkgrey);
+
+        // Threshold marker
+        const auto thresholdX = dbToX(threshold, bounds);
+        geometry.addLine({ thresholdX, 0.0f }, { thresholdX, bounds.getHeight() }, 1.0f, juce::Colours::orange.withAlpha(0.5f));
+
+        // The input/output curve, makeup included
+        curvePoints.clear();
+
+        for (int i = 0; i < numCurvePoints; ++i)
+        {
+            const auto input = juce::jmap((float)i, 0.0f, (float)(numCurvePoints - 1), floorDb, 0.0f);
+            const auto output = input - LookaheadCompressor<float>::computeGainReduction(input, threshold, ratio) + makeup;
+
+            curvePoints.push_back({ dbToX(input, bounds), dbToY(juce::jmin(output, 0.0f), bounds) });
+        }
+
+        geometry.addPolyline(curvePoints, 2.0f, enabled ? juce::Colours::lightgreen : juce::Colours::grey);
+
+        // Gain reduction meter, hanging down from the top
+        geometry.addRectangle(meterArea, juce::Colour(0xff202020));
+
+        if (enabled && gainReduction > 0.0f)
+            geometry.addRectangle(meterArea.withHeight(meterArea.getHeight() * juce::jmin(gainReduction, maxMeterDb) / maxMeterDb),
+                                  juce::Colours::orange);
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        g.setFont(12.0f);
+        g.setColour(juce::Colours::white);
+        g.drawText("In", getWidth() - (int)meterWidth - 35, getHeight() - 20, 25, 20, juce::Justification::right);
+        g.drawText("Out", 5, 5, 30, 20, juce::Justification::left);
+
+        g.setColour(juce::Colours::orange);
+        g.drawText("GR " + juce::String(enabled ? gainReduction : 0.0f, 1) + " dB",
+                   getWidth() - (int)meterWidth - 95, 5, 85, 20, juce::Justification::right);
+    }
+
+private:
+    static constexpr int numCurvePoints = 121;
+    static constexpr float floorDb = -60.0f;
+    static constexpr float maxMeterDb = 24.0f;
+    static constexpr float meterWidth = 12.0f;
+
+    static float dbToX(float db, juce::Rectangle<float> bounds)
+    {
+        return juce::jmap(db, floorDb, 0.0f, 0.0f, bounds.getWidth());
+    }
+
+    static float dbToY(float db, juce::Rectangle<float> bounds)
+    {
+        return juce::jmap(db, 0.0f, floorDb, 0.0f, bounds.getHeight());
+    }
+
+    void setValue(float& value, float newValue)
+    {
+        if (newValue != value)
+        {
+            value = newValue;
+            geometryChanged();
+        }
+    }
+
+    float threshold = -18.0f;
+    float ratio = 4.0f;
+    float makeup = 0.0f;
+    float gainReduction = 0.0f;
+    bool enabled = false;
+    std::vector<juce::Point<float>> curvePoints;
+};
+
+// Distortion visualization component.
+// Draws the same transfer curve the DSP uses (ShaperCurves), rebuilt only when
+// the amount, type or size changes.
+class WaveShapeDisplay : public GeometryDisplay
 {
 public:
     WaveShapeDisplay()
+        : GeometryDisplay(juce::Colours::black)
     {
-        setOpaque(true);
+        curvePoints.reserve(numCurvePoints);
     }
 
-    void setDistortionType(int type) { distortionType = type; repaint(); }
-    void setAmount(float amount) { distortionAmount = amount; repaint(); }
+    void setDistortionType(int type)
+    {
+        if (type != distortionType)
+        {
+            distortionType = type;
+            geometryChanged();
+        }
+    }
 
-    void paint(juce::Graphics& g) override
+    void setAmount(float amount)
     {
-        // Background
-        g.fillAll(juce::Colours::black);
+        if (amount != distortionAmount)
+        {
+            distortionAmount = amount;
+            geometryChanged();
+        }
+    }
 
-        // Grid lines
-        g.setColour(juce::Colours::darkgrey);
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
         auto bounds = getLocalBounds().toFloat();
         float centerX = bounds.getCentreX();
         float centerY = bounds.getCentreY();
 
-        // Draw center lines
-        g.drawLine(0, centerY, bounds.getWidth(), centerY, 1.0f);
-        g.drawLine(centerX, 0, centerX, bounds.getHeight(), 1.0f);
+        // Center lines
+        geometry.addLine({ 0.0f, centerY }, { bounds.getWidth(), centerY }, 1.0f, juce::Colours::darkgrey);
+        geometry.addLine({ centerX, 0.0f }, { centerX, bounds.getHeight() }, 1.0f, juce::Colours::darkgrey);
 
-        // Draw the input/output curve
-        g.setColour(juce::Colours::lightgreen);
-
-        juce::Path curvePath;
-        bool pathStarted = false;
+        // The input/output curve
+        curvePoints.clear();
 
-        // Generate the distortion curve
-        for (float x = -1.0f; x <= 1.0f; x += 0.01f)
+        for (int i = 0; i < numCurvePoints; ++i)
         {
-            float input = x;
-            float output = processSample(input, distortionAmount, distortionType);
+            float input = juce::jmap((float)i, 0.0f, (float)(numCurvePoints - 1), -1.0f, 1.0f);
+            float output = ShaperCurves::process(distortionType, distortionAmount, input);
 
             // Map to component coordinates
-            float displayX = juce::jmap(input, -1.0f, 1.0f, 0.0f, bounds.getWidth());
-            float displayY = juce::jmap(output, 1.0f, -1.0f, 0.0f, bounds.getHeight());
-
-            if (!pathStarted)
-            {
-                curvePath.startNewSubPath(displayX, displayY);
-                pathStarted = true;
-            }
-            else
-            {
-                curvePath.lineTo(displayX, displayY);
-            }
+            curvePoints.push_back({ juce::jmap(input, -1.0f, 1.0f, 0.0f, bounds.getWidth()),
+                                    juce::jmap(output, 1.0f, -1.0f, 0.0f, bounds.getHeight()) });
         }
 
-        g.strokePath(curvePath, juce::PathStrokeType(2.0f));
+        geometry.addPolyline(curvePoints, 2.0f, juce::Colours::lightgreen);
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        float centerX = bounds.getCentreX();
+        float centerY = bounds.getCentreY();
 
         // Draw labels
         g.setColour(juce::Colours::white);
@@ -67,146 +202,673 @@ public:
     }
 
 private:
-    float processSample(float sample, float drive, int type)
+    static constexpr int numCurvePoints = 201;
+
+    int distortionType = 0;
+    float distortionAmount = 0.0f;
+    std::vector<juce::Point<float>> curvePoints;
+};
+
+// Impulse response visualization component.
+// Draws the loaded IR's peak envelope from its overview, mirrored about the
+// centre, with its name and length on top. Shows the loader's state while
+// there's nothing to draw.
+class ImpulseResponseDisplay : public GeometryDisplay
+{
+public:
+    ImpulseResponseDisplay()
+        : GeometryDisplay(juce::Colours::black)
     {
-        float output = sample;
-        drive = 1.0f + 20.0f * std::pow(drive, 2.0f);
+    }
 
-        switch (type)
+    void setStatus(const ConvolutionStage::Status& newStatus)
+    {
+        status = newStatus;
+        geometryChanged();
+    }
+
+    void setMix(float newMix)
+    {
+        if (newMix != mix)
         {
-        case 0: // Soft Clip (Tanh)
-            output = std::tanh(sample * drive) / std::tanh(drive);
-            break;
+            mix = newMix;
+            geometryChanged();
+        }
+    }
 
-        case 1: // Hard Clip
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        const auto bounds = getLocalBounds().toFloat();
+        const auto centerY = bounds.getCentreY();
+
+        geometry.addLine({ 0.0f, centerY }, { bounds.getWidth(), centerY }, 1.0f, juce::Colours::darkgrey);
+
+        if (status.response == nullptr)
+            return;
+
+        // One bar per overview slice, its height following the peak level and the mix
+        const auto& overview = status.response->getOverview();
+        const auto barWidth = bounds.getWidth() / (float)overview.size();
+        const auto halfHeight = (bounds.getHeight() * 0.5f - 5.0f) * juce::jmax(mix, 0.05f);
+
+        for (size_t slice = 0; slice < overview.size(); ++slice)
+        {
+            const auto x = (float)slice * barWidth;
+            const auto extent = juce::jmax(0.5f, overview[slice] * halfHeight);
+
+            geometry.addRectangle({ x, centerY - extent, juce::jmax(1.0f, barWidth - 0.5f), extent * 2.0f },
+                                  juce::Colours::lightgreen.withAlpha(0.8f));
+        }
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        g.setFont(12.0f);
+
+        switch (status.state)
+        {
+            case ConvolutionStage::State::empty:
+                g.setColour(juce::Colours::grey);
+                g.drawText("No impulse response loaded", getLocalBounds(), juce::Justification::centred);
+                break;
+
+            case ConvolutionStage::State::loading:
+                g.setColour(juce::Colours::white);
+                g.drawText("Loading " + status.file.getFileName() + "...", getLocalBounds(), juce::Justification::centred);
+                break;
+
+            case ConvolutionStage::State::failed:
+                g.setColour(juce::Colours::orange);
+                g.drawText(status.file.getFileName() + ": " + status.message, getLocalBounds(), juce::Justification::centred);
+                break;
+
+            case ConvolutionStage::State::ready:
+                break;
+        }
+
+        if (status.response != nullptr)
         {
-            float threshold = 1.0f / drive;
-            output = juce::jlimit(-threshold, threshold, sample);
-            output *= drive * 0.5f;
+            const auto seconds = status.response->getLength() / status.response->getSampleRate();
+
+            g.setColour(juce::Colours::white);
+            g.drawText(status.response->getName(), 10, 5, getWidth() - 100, 20, juce::Justification::left);
+            g.drawText(juce::String(seconds * 1000.0, 0) + " ms", getWidth() - 90, 5, 80, 20, juce::Justification::right);
         }
-        break;
+    }
+
+private:
+    ConvolutionStage::Status status;
+    float mix = 1.0f;
+};
+
+// Modulation visualization component.
+// Traces where each voice's delay (chorus, flanger) or allpass break frequency
+// (phaser) goes over two LFO cycles, from the stage's own mapping
+// (ModulationStage::getDelayMilliseconds and getPhaserFrequency). Left
+// channel voices are green, right channel voices blue.
+class ModulationDisplay : public GeometryDisplay
+{
+public:
+    ModulationDisplay()
+        : GeometryDisplay(juce::Colours::black)
+    {
+        points.reserve(numPoints);
+    }
 
-        case 2: // Tube
+    void setMode(int newMode)
+    {
+        if (newMode != mode)
         {
-            float x = sample * drive;
-            if (x > 0)
-                output = 1.0f - std::exp(-x);
-            else
-                output = -1.0f + std::exp(x);
+            mode = newMode;
+            geometryChanged();
         }
-        break;
+    }
+
+    void setRate(float newRate) { setValue(rate, newRate); }
+    void setDepth(float newDepth) { setValue(depth, newDepth); }
+    void setMix(float newMix) { setValue(mix, newMix); }
+
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        const auto bounds = getLocalBounds().toFloat();
+        const auto centreY = bounds.getCentreY();
+
+        geometry.addLine({ 0.0f, centreY }, { bounds.getWidth(), centreY }, 1.0f, juce::Colours::darkgrey);
+        geometry.addLine({ bounds.getCentreX(), 0.0f }, { bounds.getCentreX(), bounds.getHeight() }, 1.0f, juce::Colour(0xff303030));
 
-        case 3: // Diode
+        const auto stageMode = (ModulationStage<float>::Mode)mode;
+        const auto alpha = mix > 0.0f ? 1.0f : 0.4f;
+
+        for (int voice = 0; voice < ModulationStage<float>::numVoices; ++voice)
         {
-            float x = sample * drive;
-            output = x / (1.0f + std::abs(x));
-            if (x > 0)
-                output *= 0.9f;
+            // Flanger and phaser voices on a channel share one sweep; draw it once
+            if (stageMode != ModulationStage<float>::Mode::chorus && voice % 2 == 1)
+                continue;
+
+            const auto phase = ModulationStage<float>::getVoicePhase(stageMode, voice);
+            points.clear();
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const auto cycles = 2.0f * (float)i / (float)(numPoints - 1);
+                const auto lfo = std::sin(juce::MathConstants<float>::twoPi * (cycles + phase));
+
+                points.push_back({ bounds.getWidth() * cycles * 0.5f, valueToY(stageMode, lfo, bounds) });
+            }
+
+            const auto colour = voice < ModulationStage<float>::numVoices / 2 ? juce::Colours::lightgreen : juce::Colours::lightblue;
+            geometry.addPolyline(points, 2.0f, colour.withAlpha(alpha));
         }
-        break;
+    }
 
-        case 4: // Fold
+    void paintOverlay(juce::Graphics& g) override
+    {
+        const auto stageMode = (ModulationStage<float>::Mode)mode;
+
+        g.setColour(juce::Colours::white);
+        g.setFont(12.0f);
+        g.drawText(juce::String(2.0f / rate, 2) + "s", getWidth() - 55, getHeight() - 20, 50, 20, juce::Justification::right);
+
+        if (stageMode == ModulationStage<float>::Mode::phaser)
         {
-            float x = sample * drive * 3.0f;
-            output = std::sin(x) / (1.0f + 0.2f * std::abs(x));
+            g.drawText(juce::String(ModulationStage<float>::getPhaserFrequency(depth, 1.0f), 0) + " Hz", 5, 5, 80, 20, juce::Justification::left);
+            g.drawText(juce::String(ModulationStage<float>::getPhaserFrequency(depth, -1.0f), 0) + " Hz", 5, getHeight() - 20, 80, 20, juce::Justification::left);
         }
-        break;
+        else
+        {
+            g.drawText(juce::String(ModulationStage<float>::getDelayMilliseconds(stageMode, depth, 1.0f), 1) + " ms", 5, 5, 80, 20, juce::Justification::left);
+            g.drawText(juce::String(ModulationStage<float>::getDelayMilliseconds(stageMode, depth, -1.0f), 1) + " ms", 5, getHeight() - 20, 80, 20, juce::Justification::left);
+        }
+    }
 
-        case 5: // Sine
+private:
+    static constexpr int numPoints = 201;
+
+    // The full swing of the mode fills the height, so depth shows as the trace's size
+    float valueToY(ModulationStage<float>::Mode stageMode, float lfo, juce::Rectangle<float> bounds) const
+    {
+        float position = 0.0f;
+
+        if (stageMode == ModulationStage<float>::Mode::phaser)
         {
-            float x = sample * drive;
-            output = std::sin(x * juce::MathConstants<float>::pi * 0.5f);
+            const auto lowest = std::log2(ModulationStage<float>::getPhaserFrequency(1.0f, -1.0f));
+            const auto highest = std::log2(ModulationStage<float>::getPhaserFrequency(1.0f, 1.0f));
+            position = (std::log2(ModulationStage<float>::getPhaserFrequency(depth, lfo)) - lowest) / (highest - lowest);
         }
-        break;
+        else
+        {
+            const auto lowest = ModulationStage<float>::getDelayMilliseconds(stageMode, 1.0f, -1.0f);
+            const auto highest = ModulationStage<float>::getDelayMilliseconds(stageMode, 1.0f, 1.0f);
+            position = (ModulationStage<float>::getDelayMilliseconds(stageMode, depth, lfo) - lowest) / (highest - lowest);
         }
 
-        return output;
+        return juce::jmap(position, 1.0f, 0.0f, 10.0f, bounds.getHeight() - 10.0f);
     }
 
-    int distortionType = 0;
-    float distortionAmount = 0.0f;
+    void setValue(float& value, float newValue)
+    {
+        if (newValue != value)
+        {
+            value = newValue;
+            geometryChanged();
+        }
+    }
+
+    int mode = 0;
+    float rate = 0.8f;
+    float depth = 0.5f;
+    float mix = 0.0f;
+    std::vector<juce::Point<float>> points;
 };
 
 // Delay visualization component
-class DelayDisplay : public juce::Component
+class DelayDisplay : public GeometryDisplay
 {
 public:
     DelayDisplay()
+        : GeometryDisplay(juce::Colours::black)
     {
-        setOpaque(true);
     }
 
-    void setDelayTime(float time) { delayTime = time; repaint(); }
-    void setFeedback(float fb) { feedback = fb; repaint(); }
-    void setMix(float mx) { mix = mx; repaint(); }
+    void setDelayTime(float time) { setValue(delayTime, time); }
+    void setFeedback(float fb) { setValue(feedback, fb); }
+    void setMix(float mx) { setValue(mix, mx); }
 
-    void paint(juce::Graphics& g) override
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
     {
-        // Background
-        g.fillAll(juce::Colours::black);
-
-        // Draw time grid
-        g.setColour(juce::Colours::darkgrey);
-        auto bounds = getLocalBounds().toFloat();
-        float width = bounds.getWidth();
-        float height = bounds.getHeight();
+        const auto layout = getLayout();
 
-        // Draw center horizontal line
-        g.drawLine(0, height / 2, width, height / 2, 1.0f);
+        // Center horizontal line
+        geometry.addLine({ 0.0f, layout.centerY }, { layout.width, layout.centerY }, 1.0f, juce::Colours::darkgrey);
 
-        // Draw echo visualization
-        g.setColour(juce::Colours::lightblue);
+        // Original impulse
+        geometry.addLine({ layout.impulseX, layout.centerY - layout.amplitude },
+                         { layout.impulseX, layout.centerY + layout.amplitude }, 2.0f, juce::Colours::lightblue);
 
-        // Original signal
-        float centerY = height / 2;
-        float amplitude = height * 0.3f;
-
-        // Draw original impulse
-        float impulseX = width * 0.1f;
-        g.drawLine(impulseX, centerY - amplitude, impulseX, centerY + amplitude, 2.0f);
-        g.setFont(12.0f);
-        g.drawText("Input", impulseX - 20, centerY + amplitude + 5, 40, 20, juce::Justification::centred);
-
-        // Draw delay time marker
-        float delayX = impulseX + width * 0.7f * delayTime;
-        g.setColour(juce::Colours::red);
-        g.drawLine(delayX, centerY - 5, delayX, centerY + 5, 1.0f);
-        g.drawText(juce::String(delayTime, 2) + "s", delayX - 20, centerY - 25, 40, 20, juce::Justification::centred);
+        // Delay time marker
+        geometry.addLine({ layout.delayX, layout.centerY - 5 }, { layout.delayX, layout.centerY + 5 }, 1.0f, juce::Colours::red);
 
-        // Draw echoes with feedback decay
-        g.setColour(juce::Colours::cyan);
-        float currentAmp = amplitude * mix;
-        float currentX = delayX;
+        // Echoes with feedback decay
+        float currentAmp = layout.amplitude * mix;
+        float currentX = layout.delayX;
 
         for (int i = 0; i < 5; i++)
         {
             if (currentAmp < 2.0f)
                 break;
 
-            g.drawLine(currentX, centerY - currentAmp, currentX, centerY + currentAmp, 2.0f);
+            geometry.addLine({ currentX, layout.centerY - currentAmp }, { currentX, layout.centerY + currentAmp },
+                             2.0f, juce::Colours::cyan);
 
             // Next echo
             currentAmp *= feedback;
-            currentX += (delayX - impulseX);
+            currentX += (layout.delayX - layout.impulseX);
 
-            if (currentX > width - 10)
+            if (currentX > layout.width - 10)
                 break;
         }
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        const auto layout = getLayout();
+
+        g.setColour(juce::Colours::lightblue);
+        g.setFont(12.0f);
+        g.drawText("Input", layout.impulseX - 20, layout.centerY + layout.amplitude + 5, 40, 20, juce::Justification::centred);
 
-        // Draw feedback indicator
+        g.setColour(juce::Colours::red);
+        g.drawText(juce::String(delayTime, 2) + "s", layout.delayX - 20, layout.centerY - 25, 40, 20, juce::Justification::centred);
+
+        // Feedback indicator
         g.setColour(juce::Colours::white);
-        g.drawText("Feedback: " + juce::String(feedback, 2), width - 100, 10, 90, 20, juce::Justification::right);
-        g.drawText("Mix: " + juce::String(mix, 2), width - 100, 30, 90, 20, juce::Justification::right);
+        g.drawText("Feedback: " + juce::String(feedback, 2), layout.width - 100, 10, 90, 20, juce::Justification::right);
+        g.drawText("Mix: " + juce::String(mix, 2), layout.width - 100, 30, 90, 20, juce::Justification::right);
     }
 
 private:
+    struct Layout
+    {
+        float width, centerY, amplitude, impulseX, delayX;
+    };
+
+    Layout getLayout() const
+    {
+        auto bounds = getLocalBounds().toFloat();
+        float width = bounds.getWidth();
+        float height = bounds.getHeight();
+        float impulseX = width * 0.1f;
+
+        return { width, height / 2, height * 0.3f, impulseX, impulseX + width * 0.7f * delayTime };
+    }
+
+    void setValue(float& value, float newValue)
+    {
+        if (newValue != value)
+        {
+            value = newValue;
+            geometryChanged();
+        }
+    }
+
     float delayTime = 0.3f;
     float feedback = 0.4f;
     float mix = 0.5f;
 };
 
+// Reverb visualization component.
+// Plots the tail's level against time for a low and a high frequency, using
+// the same decay model the FDN uses (FdnReverb::getDecaySeconds), so the gap
+// between the two lines shows what the damping does.
+class ReverbDisplay : public GeometryDisplay
+{
+public:
+    ReverbDisplay()
+        : GeometryDisplay(juce::Colours::black)
+    {
+    }
+
+    void setRoomSize(float newSize) { setValue(roomSize, newSize); }
+    void setDecay(float newDecay) { setValue(decay, newDecay); }
+    void setDamping(float newDamping) { setValue(damping, newDamping); }
+    void setMix(float newMix) { setValue(mix, newMix); }
+
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        const auto bounds = getLocalBounds().toFloat();
+        const auto axisSeconds = getAxisSeconds();
+
+        // One grid line per second, or per 100 ms for short decays
+        const auto gridStep = axisSeconds > 2.0f ? 1.0f : 0.1f;
+
+        for (float t = gridStep; t < axisSeconds; t += gridStep)
+        {
+            const auto x = timeToX(t, bounds);
+            geometry.addLine({ x, 0.0f }, { x, bounds.getHeight() }, 1.0f, juce::Colour(0xff303030));
+        }
+
+        for (float db = -20.0f; db > floorDb; db -= 20.0f)
+        {
+            const auto y = dbToY(db, bounds);
+            geometry.addLine({ 0.0f, y }, { bounds.getWidth(), y }, 1.0f, juce::Colour(0xff303030));
+        }
+
+        // The tail falls in a straight line in dB, starting at the wet level
+        const auto startDb = juce::Decibels::gainToDecibels(mix, floorDb);
+
+        if (startDb <= floorDb)
+            return;
+
+        const auto addDecay = [&](float frequency, juce::Colour colour)
+        {
+            const auto seconds = FdnReverb<float>::getDecaySeconds(roomSize, decay, damping, frequency, displaySampleRate);
+            const auto endSeconds = seconds * (startDb - floorDb) / 60.0f;
+
+            geometry.addLine({ timeToX(0.0f, bounds), dbToY(startDb, bounds) },
+                             { timeToX(endSeconds, bounds), dbToY(floorDb, bounds) }, 2.0f, colour);
+        };
+
+        addDecay(highFrequency, juce::Colours::orange);
+        addDecay(lowFrequency, juce::Colours::lightblue);
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        const auto highSeconds = FdnReverb<float>::getDecaySeconds(roomSize, decay, damping, highFrequency, displaySampleRate);
+
+        g.setFont(12.0f);
+        g.setColour(juce::Colours::lightblue);
+        g.drawText("Low RT60: " + juce::String(decay, 2) + "s", getWidth() - 130, 10, 120, 20, juce::Justification::right);
+        g.setColour(juce::Colours::orange);
+        g.drawText("8 kHz RT60: " + juce::String(highSeconds, 2) + "s", getWidth() - 130, 30, 120, 20, juce::Justification::right);
+
+        g.setColour(juce::Colours::white);
+        g.drawText(juce::String(getAxisSeconds(), 1) + "s", getWidth() - 45, getHeight() - 20, 40, 20, juce::Justification::right);
+    }
+
+private:
+    static constexpr float floorDb = -60.0f;
+    static constexpr float lowFrequency = 200.0f;
+    static constexpr float highFrequency = 8000.0f;
+    static constexpr double displaySampleRate = 48000.0;
+
+    // Shortest of 1, 2, 5 or 10 seconds that fits the whole decay
+    float getAxisSeconds() const
+    {
+        for (auto seconds : { 1.0f, 2.0f, 5.0f })
+            if (decay <= seconds)
+                return seconds;
+
+        return 10.0f;
+    }
+
+    float timeToX(float seconds, juce::Rectangle<float> bounds) const
+    {
+        return juce::jmap(seconds, 0.0f, getAxisSeconds(), 0.0f, bounds.getWidth());
+    }
+
+    static float dbToY(float db, juce::Rectangle<float> bounds)
+    {
+        return juce::jmap(db, 0.0f, floorDb, 10.0f, bounds.getHeight());
+    }
+
+    void setValue(float& value, float newValue)
+    {
+        if (newValue != value)
+        {
+            value = newValue;
+            geometryChanged();
+        }
+    }
+
+    float roomSize = 0.5f;
+    float decay = 1.5f;
+    float damping = 0.5f;
+    float mix = 0.0f;
+};
+
+// Live levels and output scope, fed from the processor's MeterFeed
+class SignalMonitor : public GeometryDisplay
+{
+public:
+    static constexpr int scopeLength = 250;     // points shown, newest on the right
+    static constexpr float meterFloorDb = -60.0f;
+
+    SignalMonitor()
+        : GeometryDisplay(juce::Colours::black)
+    {
+    }
+
+    // Folds one timer tick's worth of frames and scope points into the display
+    void update(const MeterFeed::Frame* frames, int numFrames, const MeterFeed::ScopePoint* points, int numPoints)
+    {
+        std::array<float, numMeters> peaks {}, sumOfSquares {};
+        int numSamples = 0;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            const auto& frame = frames[i];
+
+            for (int channel = 0; channel < frame.numChannels; ++channel)
+            {
+                for (int point = 0; point < MeterFeed::numPoints; ++point)
+                {
+                    const auto& levels = frame.levels[point][channel];
+                    const int meter = point == MeterFeed::output ? outputMeter : point;
+                    peaks[(size_t)meter] = juce::jmax(peaks[(size_t)meter], levels.peak);
+                    sumOfSquares[(size_t)meter] += levels.rms * levels.rms * (float)frame.numSamples / (float)frame.numChannels;
+                }
+
+                peaks[(size_t)tapMeter] = juce::jmax(peaks[(size_t)tapMeter], frame.delayTapPeak[channel]);
+            }
+
+            numSamples += frame.numSamples;
+        }
+
+        // Peaks fall back slowly, RMS follows what was measured since the last tick
+        for (size_t meter = 0; meter < (size_t)numMeters; ++meter)
+        {
+            peakLevels[meter] = juce::jmax(peaks[meter], peakLevels[meter] * peakDecay);
+
+            if (numSamples > 0)
+                rmsLevels[meter] = std::sqrt(sumOfSquares[meter] / (float)numSamples);
+        }
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            scope[(size_t)scopeWritePosition] = points[i];
+            scopeWritePosition = (scopeWritePosition + 1) % scopeLength;
+        }
+
+        if (numFrames > 0 || numPoints > 0)
+            geometryChanged();
+    }
+
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        auto meterArea = getMeterArea();
+
+        // One bar per point in the chain: RMS filled, peak as a line
+        for (size_t meter = 0; meter < (size_t)numMeters; ++meter)
+        {
+            auto bar = getMeterRow(meterArea).withTrimmedLeft(meterLabelWidth).reduced(0.0f, 3.0f);
+            geometry.addRectangle(bar, juce::Colours::darkgrey);
+            geometry.addRectangle(bar.withWidth(bar.getWidth() * levelToProportion(rmsLevels[meter])), juce::Colours::lightgreen);
+
+            const float peakX = bar.getX() + bar.getWidth() * levelToProportion(peakLevels[meter]);
+            geometry.addRectangle({ peakX, bar.getY(), 1.0f, bar.getHeight() },
+                                  peakLevels[meter] >= 1.0f ? juce::Colours::red : juce::Colours::yellow);
+        }
+
+        // Output scope, one vertical min/max line per point
+        auto scopeArea = getScopeArea();
+        geometry.addRectangle({ scopeArea.getX(), scopeArea.getCentreY(), scopeArea.getWidth(), 1.0f }, juce::Colours::darkgrey);
+
+        const float xStep = scopeArea.getWidth() / (float)scopeLength;
+
+        for (int i = 0; i < scopeLength; ++i)
+        {
+            const auto& point = scope[(size_t)((scopeWritePosition + i) % scopeLength)];
+            const float top = juce::jmap(juce::jlimit(-1.0f, 1.0f, point.max), 1.0f, -1.0f, scopeArea.getY(), scopeArea.getBottom());
+            const float bottom = juce::jmap(juce::jlimit(-1.0f, 1.0f, point.min), 1.0f, -1.0f, scopeArea.getY(), scopeArea.getBottom());
+            geometry.addRectangle({ scopeArea.getX() + (float)i * xStep, top, 1.0f, juce::jmax(bottom - top, 1.0f) }, juce::Colours::cyan);
+        }
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        const char* names[numMeters] = { "In", "Drive", "Tap", "Out" };
+        auto meterArea = getMeterArea();
+
+        g.setColour(juce::Colours::white);
+        g.setFont(11.0f);
+
+        for (auto* name : names)
+            g.drawText(name, getMeterRow(meterArea).withWidth(meterLabelWidth), juce::Justification::centredLeft);
+    }
+
+private:
+    // Meters in chain order; the tap sits between the distortion and the output
+    static constexpr int numMeters = 4;
+    static constexpr int tapMeter = 2;
+    static constexpr int outputMeter = 3;
+    static constexpr float peakDecay = 0.85f;   // per timer tick
+    static constexpr float meterLabelWidth = 36.0f;
+
+    static float levelToProportion(float level)
+    {
+        const float db = juce::Decibels::gainToDecibels(level, meterFloorDb);
+        return juce::jlimit(0.0f, 1.0f, juce::jmap(db, meterFloorDb, 0.0f, 0.0f, 1.0f));
+    }
+
+    juce::Rectangle<float> getMeterArea() const
+    {
+        auto bounds = getLocalBounds().toFloat();
+        return bounds.removeFromLeft(bounds.getWidth() * 0.4f).reduced(4.0f);
+    }
+
+    juce::Rectangle<float> getScopeArea() const
+    {
+        auto bounds = getLocalBounds().toFloat();
+        return bounds.withTrimmedLeft(bounds.getWidth() * 0.4f).reduced(4.0f);
+    }
+
+    // Takes the next meter's row off the top of the meter area
+    juce::Rectangle<float> getMeterRow(juce::Rectangle<float>& meterArea) const
+    {
+        return meterArea.removeFromTop(getMeterArea().getHeight() / (float)numMeters);
+    }
+
+    std::array<float, numMeters> peakLevels {}, rmsLevels {};
+    std::array<MeterFeed::ScopePoint, scopeLength> scope {};
+    int scopeWritePosition = 0;
+};
+
+// Input and output spectrum from the processor's SpectrumAnalyser, on a log
+// frequency axis from 20 Hz to 20 kHz
+class SpectrumDisplay : public GeometryDisplay
+{
+public:
+    SpectrumDisplay()
+        : GeometryDisplay(juce::Colours::black)
+    {
+        points.reserve(SpectrumAnalyser::numBands);
+
+        for (auto& spectrum : spectra)
+        {
+            spectrum.level.fill(SpectrumAnalyser::floorDb);
+            spectrum.peak.fill(SpectrumAnalyser::floorDb);
+        }
+    }
+
+    void update(const std::array<SpectrumAnalyser::Spectrum, SpectrumAnalyser::numSignals>& newSpectra,
+                const SpectrumAnalyser& analyser)
+    {
+        spectra = newSpectra;
+
+        for (int band = 0; band < SpectrumAnalyser::numBands; ++band)
+            bandFrequencies[(size_t)band] = analyser.getBandFrequency(band);
+
+        geometryChanged();
+    }
+
+protected:
+    void buildGeometry(DisplayGeometry& geometry) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        // Frequency grid, with 5 kHz picked out since that's where the shapers differ most
+        for (auto frequency : gridFrequencies)
+            geometry.addLine({ xForFrequency(frequency), 0.0f }, { xForFrequency(frequency), bounds.getHeight() }, 1.0f,
+                             frequency == 5000.0f ? juce::Colours::grey : juce::Colours::darkgrey);
+
+        for (float db = -20.0f; db > displayFloorDb; db -= 20.0f)
+            geometry.addLine({ 0.0f, yForDb(db) }, { bounds.getWidth(), yForDb(db) }, 1.0f, juce::Colours::darkgrey);
+
+        addCurve(geometry, spectra[SpectrumAnalyser::input].level, 1.5f, juce::Colours::grey);
+        addCurve(geometry, spectra[SpectrumAnalyser::output].peak, 1.0f, juce::Colours::yellow.withAlpha(0.6f));
+        addCurve(geometry, spectra[SpectrumAnalyser::output].level, 2.0f, juce::Colours::lightgreen);
+    }
+
+    void paintOverlay(juce::Graphics& g) override
+    {
+        g.setFont(11.0f);
+        g.setColour(juce::Colours::white);
+
+        for (auto frequency : gridFrequencies)
+        {
+            auto label = frequency >= 1000.0f ? juce::String(frequency / 1000.0f, 0) + "k" : juce::String(frequency, 0);
+            g.drawText(label, (int)xForFrequency(frequency) + 3, getHeight() - 16, 30, 14, juce::Justification::left);
+        }
+
+        g.setColour(juce::Colours::grey);
+        g.drawText("In", getWidth() - 60, 5, 25, 14, juce::Justification::right);
+        g.setColour(juce::Colours::lightgreen);
+        g.drawText("Out", getWidth() - 30, 5, 25, 14, juce::Justification::right);
+    }
+
+private:
+    static constexpr float maxDisplayFrequency = 20000.0f;
+    static constexpr float displayFloorDb = -90.0f;
+    static constexpr std::array<float, 5> gridFrequencies { 100.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f };
+
+    float xForFrequency(float frequency) const
+    {
+        const auto proportion = std::log(frequency / SpectrumAnalyser::minFrequency)
+                                / std::log(maxDisplayFrequency / SpectrumAnalyser::minFrequency);
+        return proportion * (float)getWidth();
+    }
+
+    float yForDb(float db) const
+    {
+        return juce::jmap(juce::jlimit(displayFloorDb, 0.0f, db), displayFloorDb, 0.0f, (float)getHeight(), 0.0f);
+    }
+
+    void addCurve(DisplayGeometry& geometry, const std::array<float, SpectrumAnalyser::numBands>& levels,
+                  float thickness, juce::Colour colour)
+    {
+        points.clear();
+
+        for (size_t band = 0; band < levels.size(); ++band)
+            if (bandFrequencies[band] >= SpectrumAnalyser::minFrequency && bandFrequencies[band] <= maxDisplayFrequency)
+                points.push_back({ xForFrequency(bandFrequencies[band]), yForDb(levels[band]) });
+
+        geometry.addPolyline(points, thickness, colour);
+    }
+
+    std::array<SpectrumAnalyser::Spectrum, SpectrumAnalyser::numSignals> spectra {};
+    std::array<float, SpectrumAnalyser::numBands> bandFrequencies {};
+    std::vector<juce::Point<float>> points;
+};
+
 // Main editor class
-class _3ff3ctsAudioProcessorEditor : public juce::AudioProcessorEditor
+class _3ff3ctsAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                     private juce::Timer
 {
 public:
     _3ff3ctsAudioProcessorEditor(_3ff3ctsAudioProcessor&);
@@ -219,8 +881,32 @@ private:
     _3ff3ctsAudioProcessor& audioProcessor;
 
     // Interface components
+    juce::TextButton compressorButton;
     juce::TextButton distortionButton;
+    juce::TextButton convolutionButton;
+    juce::TextButton modulationButton;
     juce::TextButton delayButton;
+    juce::TextButton reverbButton;
+    juce::TextButton spectrumButton;
+    juce::ToggleButton gpuButton;
+    juce::ComboBox chainOrderComboBox;
+
+    // Compressor components
+    juce::Component compressorPanel;
+    juce::ToggleButton compressorEnabledButton;
+    juce::Slider compressorThresholdSlider;
+    juce::Label compressorThresholdLabel;
+    juce::Slider compressorRatioSlider;
+    juce::Label compressorRatioLabel;
+    juce::Slider compressorAttackSlider;
+    juce::Label compressorAttackLabel;
+    juce::Slider compressorReleaseSlider;
+    juce::Label compressorReleaseLabel;
+    juce::Slider compressorLookaheadSlider;
+    juce::Label compressorLookaheadLabel;
+    juce::Slider compressorMakeupSlider;
+    juce::Label compressorMakeupLabel;
+    CompressorDisplay compressorDisplay;
 
     // Distortion components
     juce::Component distortionPanel;
@@ -230,8 +916,36 @@ private:
     juce::Label distortionLabel;
     juce::ComboBox distortionTypeComboBox;
     juce::Label distortionTypeLabel;
+    juce::ComboBox oversamplingComboBox;
+    juce::Label oversamplingLabel;
+    juce::ComboBox antiAliasingComboBox;
+    juce::Label antiAliasingLabel;
     WaveShapeDisplay waveShapeDisplay;
 
+    // Impulse response components
+    juce::Component convolutionPanel;
+    juce::TextButton loadImpulseResponseButton;
+    juce::TextButton clearImpulseResponseButton;
+    juce::Slider convolutionMixSlider;
+    juce::Label convolutionMixLabel;
+    ImpulseResponseDisplay impulseResponseDisplay;
+    std::unique_ptr<juce::FileChooser> impulseResponseChooser;
+    ConvolutionStage::Status shownImpulseResponseStatus;
+
+    // Modulation components
+    juce::Component modulationPanel;
+    juce::ComboBox modulationModeComboBox;
+    juce::Label modulationModeLabel;
+    juce::Slider modulationRateSlider;
+    juce::Label modulationRateLabel;
+    juce::Slider modulationDepthSlider;
+    juce::Label modulationDepthLabel;
+    juce::Slider modulationFeedbackSlider;
+    juce::Label modulationFeedbackLabel;
+    juce::Slider modulationMixSlider;
+    juce::Label modulationMixLabel;
+    ModulationDisplay modulationDisplay;
+
     // Delay components
     juce::Component delayPanel;
     juce::Slider delayTimeSlider;
@@ -240,18 +954,94 @@ private:
     juce::Label feedbackLabel;
     juce::Slider mixSlider;
     juce::Label mixLabel;
+    juce::ComboBox interpolationComboBox;
+    juce::Label interpolationLabel;
+    juce::ToggleButton delaySyncButton;
+    juce::ComboBox delayDivisionComboBox;
+    juce::Label delayDivisionLabel;
     DelayDisplay delayDisplay;
 
+    // Reverb components
+    juce::Component reverbPanel;
+    juce::Slider reverbSizeSlider;
+    juce::Label reverbSizeLabel;
+    juce::Slider reverbDecaySlider;
+    juce::Label reverbDecayLabel;
+    juce::Slider reverbDampingSlider;
+    juce::Label reverbDampingLabel;
+    juce::Slider reverbMixSlider;
+    juce::Label reverbMixLabel;
+    ReverbDisplay reverbDisplay;
+
+    // Spectrum components
+    juce::Component spectrumPanel;
+    SpectrumDisplay spectrumDisplay;
+
+    // Live signal, drained from the processor's meter feed on a timer
+    SignalMonitor signalMonitor;
+    std::vector<MeterFeed::Frame> meterFrames;
+    std::vector<MeterFeed::ScopePoint> scopePoints;
+    std::array<SpectrumAnalyser::Spectrum, SpectrumAnalyser::numSignals> spectra;
+    static constexpr int meterRefreshHz = 30;
+
+    // Draws the displays on the GPU when enabled and available; declared after
+    // them so it detaches before they go
+    OpenGLDisplayRenderer displayRenderer { *this };
+
+    void timerCallback() override;
+
     // Parameter attachments
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> compressorEnabledAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorThresholdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorRatioAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorAttackAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorReleaseAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorLookaheadAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> compressorMakeupAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> distortionAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> distortionTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> antiAliasingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> convolutionMixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modulationModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> modulationRateAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> modulationDepthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> modulationFeedbackAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> modulationMixAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> delayTimeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> feedbackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> interpolationAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> delaySyncAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> delayDivisionAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbSizeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbDecayAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbDampingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> reverbMixAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> chainOrderAttachment;
+
+    enum class Panel
+    {
+        compressor,
+        distortion,
+        convolution,
+        modulation,
+        delay,
+        reverb,
+        spectrum
+    };
 
+    void selectPanel(Panel panel);
+    void showCompressorPanel(bool shouldShow);
     void showDistortionPanel(bool shouldShow);
+    void showConvolutionPanel(bool shouldShow);
+    void showModulationPanel(bool shouldShow);
+    void chooseImpulseResponse();
+    void updateImpulseResponseStatus();
     void showDelayPanel(bool shouldShow);
+    void showReverbPanel(bool shouldShow);
+    void showSpectrumPanel(bool shouldShow);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(_3ff3ctsAudioProcessorEditor)
 };
\ No newline at end of file
@@ -7,27 +7,133 @@ _3ff3ctsAudioProcessor::_3ff3ctsAudioProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
     apvts(*this, nullptr, "Parameters", createParameters())
 {
-    gainParameter = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("gain"));
-    distortionParameter = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("distortion"));
-    distortionTypeParameter = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("distortionType"));
-
-    delayTimeParameter = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("delayTime"));
-    delayFeedbackParameter = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("delayFeedback"));
-    delayMixParameter = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("delayMix"));
-
-    // Initialize delay buffer
-    delayBufferLength = 44100 * 2; // 2 seconds maximum
-    delayBuffer.resize(delayBufferLength, 0.0f);
+    compressorEnabledValue = apvts.getRawParameterValue("compressorEnabled");
+    compressorThresholdValue = apvts.getRawParameterValue("compressorThreshold");
+    compressorRatioValue = apvts.getRawParameterValue("compressorRatio");
+    compressorAttackValue = apvts.getRawParameterValue("compressorAttack");
+    compressorReleaseValue = apvts.getRawParameterValue("compressorRelease");
+    compressorLookaheadValue = apvts.getRawParameterValue("compressorLookahead");
+    compressorMakeupValue = apvts.getRawParameterValue("compressorMakeup");
+
+    gainValue = apvts.getRawParameterValue("gain");
+    distortionValue = apvts.getRawParameterValue("distortion");
+    distortionTypeValue = apvts.getRawParameterValue("distortionType");
+    oversamplingValue = apvts.getRawParameterValue("oversampling");
+    antiAliasingValue = apvts.getRawParameterValue("antiAliasing");
+
+    modulationModeValue = apvts.getRawParameterValue("modulationMode");
+    modulationRateValue = apvts.getRawParameterValue("modulationRate");
+    modulationDepthValue = apvts.getRawParameterValue("modulationDepth");
+    modulationFeedbackValue = apvts.getRawParameterValue("modulationFeedback");
+    modulationMixValue = apvts.getRawParameterValue("modulationMix");
+
+    delayTimeValue = apvts.getRawParameterValue("delayTime");
+    delayFeedbackValue = apvts.getRawParameterValue("delayFeedback");
+    delayMixValue = apvts.getRawParameterValue("delayMix");
+    delayInterpolationValue = apvts.getRawParameterValue("delayInterpolation");
+    delaySyncValue = apvts.getRawParameterValue("delaySync");
+    delayDivisionValue = apvts.getRawParameterValue("delayDivision");
+
+    reverbSizeValue = apvts.getRawParameterValue("reverbSize");
+    reverbDecayValue = apvts.getRawParameterValue("reverbDecay");
+    reverbDampingValue = apvts.getRawParameterValue("reverbDamping");
+    reverbMixValue = apvts.getRawParameterValue("reverbMix");
+
+    convolutionMixValue = apvts.getRawParameterValue("convolutionMix");
+
+    chainOrderValue = apvts.getRawParameterValue("chainOrder");
+
+    for (auto* parameter : AudioProcessor::getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            apvts.addParameterListener(ranged->getParameterID(), this);
 }
 
 _3ff3ctsAudioProcessor::~_3ff3ctsAudioProcessor()
 {
+    for (auto* parameter : AudioProcessor::getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            apvts.removeParameterListener(ranged->getParameterID(), this);
+}
+
+void _3ff3ctsAudioProcessor::parameterChanged(const juce::String& parameterID, float)
+{
+    // Can arrive on any thread, so just flag the stage; processBlock does the work
+    if (parameterID.startsWith("delay"))
+        delaySettingsChanged = true;
+    else if (parameterID.startsWith("reverb"))
+        reverbSettingsChanged = true;
+    else if (parameterID.startsWith("convolution"))
+        convolutionSettingsChanged = true;
+    else if (parameterID.startsWith("compressor"))
+        compressorSettingsChanged = true;
+    else if (parameterID.startsWith("modulation"))
+        modulationSettingsChanged = true;
+    else if (parameterID.startsWith("chain"))
+        return;   // the order is read afresh every block
+    else
+        distortionSettingsChanged = true;
+
+    // A stage coming into use gets its memory, and the host the new latency, at
+    // once when the change comes from the editor; for changes on other threads
+    // the timer picks them up
+    if (juce::MessageManager::existsAndIsCurrentThread())
+    {
+        claimArenaSections();
+        updateLatency();
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout _3ff3ctsAudioProcessor::createParameters()
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
+    // Compressor parameters. It starts switched off, so sessions saved before it
+    // existed sound the same and report the same latency.
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "compressorEnabled",
+        "Compressor",
+        false));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorThreshold",
+        "Threshold",
+        -60.0f,
+        0.0f,
+        -18.0f));
+
+    // The top of the range acts as a limiter
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorRatio",
+        "Ratio",
+        juce::NormalisableRange<float>(1.0f, LookaheadCompressor<float>::limiterRatio, 0.0f, 0.5f),
+        4.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorAttack",
+        "Attack",
+        juce::NormalisableRange<float>(0.1f, 100.0f, 0.0f, 0.4f),
+        5.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorRelease",
+        "Release",
+        juce::NormalisableRange<float>(10.0f, 1000.0f, 0.0f, 0.4f),
+        100.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorLookahead",
+        "Look-ahead",
+        0.0f,
+        (float)(LookaheadCompressor<float>::maxLookaheadSeconds * 1000.0),
+        2.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "compressorMakeup",
+        "Makeup",
+        0.0f,
+        24.0f,
+        0.0f));
+
     // Distortion parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "gain",
@@ -53,12 +159,71 @@ juce::AudioProcessorValueTreeState::ParameterLayout _3ff3ctsAudioProcessor::crea
         distortionTypes,
         0));
 
+    juce::StringArray oversamplingFactors = {
+        "1x", "2x", "4x", "8x"
+    };
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling",
+        "Oversampling",
+        oversamplingFactors,
+        0));
+
+    juce::StringArray antiAliasingModes = {
+        "Off", "ADAA 1st Order", "ADAA 2nd Order"
+    };
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "antiAliasing",
+        "Anti-Aliasing",
+        antiAliasingModes,
+        0));
+
+    // Modulation parameters. The mix starts at zero so sessions saved before
+    // the modulation effects existed sound the same.
+    juce::StringArray modulationModes = {
+        "Chorus", "Flanger", "Phaser"
+    };
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "modulationMode",
+        "Modulation",
+        modulationModes,
+        0));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "modulationRate",
+        "Rate",
+        juce::NormalisableRange<float>(0.05f, 10.0f, 0.0f, 0.4f),
+        0.8f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "modulationDepth",
+        "Depth",
+        0.0f,
+        1.0f,
+        0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "modulationFeedback",
+        "Modulation Feedback",
+        -0.9f,
+        0.9f,
+        0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "modulationMix",
+        "Modulation Mix",
+        0.0f,
+        1.0f,
+        0.0f));
+
     // Delay parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "delayTime",
         "Delay Time",
         0.01f,
-        1.0f,
+        maxDelayTimeSeconds,
         0.3f));
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -75,23 +240,264 @@ juce::AudioProcessorValueTreeState::ParameterLayout _3ff3ctsAudioProcessor::crea
         1.0f,
         0.5f));
 
+    juce::StringArray delayInterpolationModes = {
+        "Linear", "Lagrange", "Allpass"
+    };
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "delayInterpolation",
+        "Delay Interpolation",
+        delayInterpolationModes,
+        1));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "delaySync",
+        "Tempo Sync",
+        false));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "delayDivision",
+        "Delay Division",
+        TempoSync::getDivisionNames(),
+        TempoSync::defaultDivision));
+
+    // Reverb parameters. The mix starts at zero so sessions saved before the
+    // reverb existed sound the same.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reverbSize",
+        "Room Size",
+        0.0f,
+        1.0f,
+        0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reverbDecay",
+        "Decay",
+        juce::NormalisableRange<float>(0.2f, 10.0f, 0.0f, 0.4f),
+        1.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reverbDamping",
+        "Damping",
+        0.0f,
+        1.0f,
+        0.5f));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "reverbMix",
+        "Reverb Mix",
+        0.0f,
+        1.0f,
+        0.0f));
+
+    // Convolution parameters. The stage does nothing until an IR is loaded, so
+    // the mix can start fully wet.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "convolutionMix",
+        "IR Mix",
+        0.0f,
+        1.0f,
+        1.0f));
+
+    // Order of the effects. The first choice is the order they had before they
+    // could be moved, so older sessions sound the same.
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "chainOrder",
+        "Chain Order",
+        getChainOrderNames(),
+        0));
+
     return { params.begin(), params.end() };
 }
 
+juce::StringArray _3ff3ctsAudioProcessor::getChainOrderNames()
+{
+    const juce::StringArray slotNames = { "Drive", "Mod", "Delay", "Reverb" };
+    jassert(slotNames.size() == numChainSlots);
+
+    juce::StringArray names;
+
+    for (int index = 0; index < Chain<float>::numOrders; ++index)
+    {
+        juce::StringArray order;
+
+        for (auto slot : Chain<float>::getOrder(index))
+            order.add(slotNames[slot]);
+
+        names.add(order.joinIntoString(" > "));
+    }
+
+    return names;
+}
+
 void _3ff3ctsAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    subBlockPhase = 0;
+    quietSamples = 0;
+    idle = false;
+
+    // The stages only ever see one sub-block at a time, whatever the host's block size
+    juce::ignoreUnused(samplesPerBlock);
+    const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32)subBlockSize, (juce::uint32)getTotalNumInputChannels() };
+
+    // Only the stages for the host's precision are prepared. The host sets the
+    // precision before calling prepareToPlay, and never changes it while playing.
+    if (isUsingDoublePrecision())
+        prepareStages<double>(spec);
+    else
+        prepareStages<float>(spec);
+
+    // A new rate or channel count re-prepares the IR in the background, or
+    // before the first block when rendering offline
+    convolution.prepare(spec, isNonRealtime());
+    convolutionSettingsChanged = true;
+
+    startTimerHz(arenaPollHz);
+
+    meterFeed.prepare(sampleRate);
+    spectrumAnalyser.prepare(sampleRate);
+}
 
-    // Resize delay buffer based on sample rate
-    delayBufferLength = (int)(2.0 * sampleRate); // 2 seconds max delay
-    delayBuffer.resize(delayBufferLength, 0.0f);
-    delayWritePosition = 0;
+template <typename SampleType>
+void _3ff3ctsAudioProcessor::prepareStages(const juce::dsp::ProcessSpec& spec)
+{
+    auto& stages = getStages<SampleType>();
+
+    // The compressor's settings go in now, as its look-ahead is part of the latency
+    stages.compressor.prepare(spec);
+    updateCompressorSettings<SampleType>();
+    compressorSettingsChanged = false;
+
+    // Prepare every oversampling factor up front so switching never allocates
+    stages.distortion.prepare(spec);
+    stages.distortion.setOversamplingOrder((int)oversamplingValue->load());
+    stages.distortion.setAntialiasingOrder((int)antiAliasingValue->load());
+    updateLatency();
+    distortionSettingsChanged = true;
+
+    stages.modulation.prepare(spec);
+    modulationSettingsChanged = true;
+
+    // One delay ring per input channel, laid out for the longest synced
+    // division at the slowest tempo we follow. Only the part the current mode
+    // needs is ever touched (see claimArenaSections).
+    const double maxDelaySeconds = juce::jmax((double)maxDelayTimeSeconds, TempoSync::getMaxDelaySeconds());
+    stages.delay.prepare(getTotalNumInputChannels(), (int)std::ceil(maxDelaySeconds * spec.sampleRate), spec.sampleRate);
+    stages.delay.setSilenceThreshold(juce::Decibels::decibelsToGain(silenceFloorDb));
+    syncedDivision = -1;
+    delaySettingsChanged = true;
+
+    stages.reverb.prepare(spec.sampleRate);
+    reverbSettingsChanged = true;
+
+    // The stages' memory comes out of one block. Only the stages in use have
+    // their pages touched now; the rest wait until their mix comes up.
+    {
+        const juce::ScopedLock lock(arenaLock);
+        arenaSampleSize = sizeof(SampleType);
+        arena.allocate({ sizeof(SampleType) * (size_t)stages.compressor.getRequiredStorage(),
+                         sizeof(SampleType) * (size_t)stages.modulation.getRequiredStorage(),
+                         sizeof(SampleType) * (size_t)stages.delay.getRequiredStorage(),
+                         sizeof(SampleType) * (size_t)stages.reverb.getRequiredStorage() });
+    }
+
+    claimArenaSections();
+    attachArenaSections<SampleType>();
 }
 
 void _3ff3ctsAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    // Give the stages' memory back until the next prepareToPlay. Both sets let
+    // go, in case the precision changed since the last one.
+    stopTimer();
+
+    const auto detach = [](auto& stages)
+    {
+        stages.compressor.setStorage(nullptr);
+        stages.modulation.setStorage(nullptr);
+        stages.delay.setStorage(nullptr, 0);
+        stages.reverb.setStorage(nullptr);
+    };
+
+    const juce::ScopedLock lock(arenaLock);
+    detach(getStages<float>());
+    detach(getStages<double>());
+    arena.release();
+}
+
+void _3ff3ctsAudioProcessor::claimArenaSections()
+{
+    const juce::ScopedLock lock(arenaLock);
+
+    // The compressor's ring is a few kilobytes, and switching it on changes the
+    // latency anyway, so it's always claimed
+    arena.claim(compressorSection);
+
+    if (modulationMixValue->load() > 0.0f)
+        arena.claim(modulationSection);
+
+    // The delay only touches the ring its mode can reach: the free range, or
+    // the longest synced time once sync is on. The rings grow into the rest of
+    // their section if sync is switched on later.
+    if (delayMixValue->load() > 0.0f)
+    {
+        const auto seconds = delaySyncValue->load() >= 0.5f ? TempoSync::getMaxDelaySeconds() : (double)maxDelayTimeSeconds;
+        const auto ringLength = MultiChannelDelay<float>::getRingLength((int)std::ceil(seconds * currentSampleRate));
+        arena.claim(delaySection, arenaSampleSize * (size_t)ringLength, getTotalNumInputChannels());
+    }
+
+    if (reverbMixValue->load() > 0.0f)
+        arena.claim(reverbSection);
+}
+
+template <typename SampleType>
+void _3ff3ctsAudioProcessor::attachArenaSections()
+{
+    auto& stages = getStages<SampleType>();
+
+    if (! stages.compressor.hasStorage())
+        if (auto* storage = arena.getSection<SampleType>(compressorSection))
+            stages.compressor.setStorage(storage);
+
+    if (! stages.modulation.hasStorage())
+        if (auto* storage = arena.getSection<SampleType>(modulationSection))
+            stages.modulation.setStorage(storage);
+
+    // The delay also picks up any more of its section claimed since
+    if (auto* storage = arena.getSection<SampleType>(delaySection))
+    {
+        const auto ringLength = (int)(arena.getClaimedBytes(delaySection) / sizeof(SampleType));
+
+        if (! stages.delay.hasStorage() || ringLength > stages.delay.getRingLength())
+            stages.delay.setStorage(storage, ringLength);
+    }
+
+    if (! stages.reverb.hasStorage())
+        if (auto* storage = arena.getSection<SampleType>(reverbSection))
+            stages.reverb.setStorage(storage);
+}
+
+void _3ff3ctsAudioProcessor::timerCallback()
+{
+    claimArenaSections();
+    updateLatency();
+}
+
+void _3ff3ctsAudioProcessor::updateLatency()
+{
+    // Worked out from the parameters, not the stages, which only take new
+    // settings at the start of the audio thread's next block
+    const auto compressorLatency = LookaheadCompressor<float>::getLatencySamples(compressorEnabledValue->load() >= 0.5f,
+                                                                                 compressorLookaheadValue->load(),
+                                                                                 currentSampleRate);
+    const auto oversampling = (int)oversamplingValue->load();
+    const auto antialiasing = (int)antiAliasingValue->load();
+    const auto distortionLatency = isUsingDoublePrecision() ? getStages<double>().distortion.getLatencySamples(oversampling, antialiasing)
+                                                            : getStages<float>().distortion.getLatencySamples(oversampling, antialiasing);
+
+    if (compressorLatency + distortionLatency != getLatencySamples())
+        setLatencySamples(compressorLatency + distortionLatency);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -118,132 +524,318 @@ bool _3ff3ctsAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 }
 #endif
 
-void _3ff3ctsAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void _3ff3ctsAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
+
+void _3ff3ctsAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void _3ff3ctsAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
+    RealtimeSafety::ScopedAudioThread audioThread;
+    auto& stages = getStages<SampleType>();
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get distortion parameters
-    float currentGain = gainParameter->get();
-    float currentDistortion = distortionParameter->get();
-    int distortionType = distortionTypeParameter->getIndex();
+    // Compressor settings
+    if (compressorSettingsChanged.exchange(false))
+        updateCompressorSettings<SampleType>();
+
+    // Distortion settings: new targets for the stage to smooth towards (gain is applied after the shaper)
+    if (distortionSettingsChanged.exchange(false))
+    {
+        stages.distortion.setParameters(distortionValue->load(), (int)distortionTypeValue->load(), gainValue->load());
+        stages.distortion.setOversamplingOrder((int)oversamplingValue->load());
+        stages.distortion.setAntialiasingOrder((int)antiAliasingValue->load());
+    }
+
+    // Delay settings
+    if (delaySettingsChanged.exchange(false))
+    {
+        // Calculate delay in samples, keeping the fraction for the interpolator
+        delaySettings.timeSamples = (float)(delayTimeValue->load() * currentSampleRate);
+        delaySettings.feedback = delayFeedbackValue->load();
+        delaySettings.mix = delayMixValue->load();
+        delaySettings.division = (int)delayDivisionValue->load();
+        delaySettings.sync = delaySyncValue->load() >= 0.5f;
+
+        stages.delay.setInterpolation((int)delayInterpolationValue->load());
+    }
+
+    // Convolution settings
+    if (convolutionSettingsChanged.exchange(false))
+        convolution.setMix(convolutionMixValue->load());
+
+    // Modulation settings
+    if (modulationSettingsChanged.exchange(false))
+        stages.modulation.setParameters((int)modulationModeValue->load(), modulationRateValue->load(), modulationDepthValue->load(),
+                                        modulationFeedbackValue->load(), modulationMixValue->load());
+
+    // Reverb settings
+    if (reverbSettingsChanged.exchange(false))
+        stages.reverb.setParameters(reverbSizeValue->load(), reverbDecayValue->load(),
+                                    reverbDampingValue->load(), reverbMixValue->load());
+
+    const auto numSamples = buffer.getNumSamples();
 
-    // Get delay parameters
-    float delayTime = delayTimeParameter->get();
-    float delayFeedback = delayFeedbackParameter->get();
-    float delayMix = delayMixParameter->get();
+    // Offline there's no deadline to miss, so a stage coming into use claims its
+    // memory here rather than waiting for the timer
+    if (isNonRealtime())
+    {
+        RealtimeSafety::ScopedExemption offlineClaim;
+        claimArenaSections();
+    }
 
-    // Process distortion
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // Stages whose memory has been claimed since the last block start using it
+    attachArenaSections<SampleType>();
+
+    // The delay time for this block. Tempo changes are followed within the block;
+    // picking a new division (or switching sync on) glides like a manual time change.
+    if (delaySettings.mix > 0.0f || stages.delay.isSmoothing())
     {
-        auto* channelData = buffer.getWritePointer(channel);
+        if (delaySettings.sync)
+        {
+            const bool divisionChanged = delaySettings.division != syncedDivision;
+            updateSyncedDelay(delaySettings.division);
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            blockDelaySamples = syncedDelaySamples;
+            delayRampsOverBlock = ! divisionChanged;
+        }
+        else
         {
-            float cleanSample = channelData[sample];
-            float distortedSample = cleanSample;
-
-            // Apply distortion if amount > 0
-            if (currentDistortion > 0.0f)
-            {
-                float drive = 1.0f + 20.0f * std::pow(currentDistortion, 2.0f);
-
-                switch (distortionType)
-                {
-                case 0: // Soft Clip (Tanh)
-                    distortedSample = std::tanh(cleanSample * drive) / std::tanh(drive);
-                    break;
-
-                case 1: // Hard Clip
-                {
-                    float threshold = 1.0f / drive;
-                    distortedSample = juce::jlimit(-threshold, threshold, cleanSample);
-                    distortedSample *= drive * 0.5f;
-                }
-                break;
-
-                case 2: // Tube
-                {
-                    float x = cleanSample * drive;
-                    if (x > 0)
-                        distortedSample = 1.0f - std::exp(-x);
-                    else
-                        distortedSample = -1.0f + std::exp(x);
-                }
-                break;
-
-                case 3: // Diode
-                {
-                    float x = cleanSample * drive;
-                    distortedSample = x / (1.0f + std::abs(x));
-                    if (x > 0)
-                        distortedSample *= 0.9f;
-                }
-                break;
-
-                case 4: // Fold
-                {
-                    float x = cleanSample * drive * 3.0f;
-                    distortedSample = std::sin(x) / (1.0f + 0.2f * std::abs(x));
-                }
-                break;
-
-                case 5: // Sine
-                {
-                    float x = cleanSample * drive;
-                    distortedSample = std::sin(x * juce::MathConstants<float>::pi * 0.5f);
-                }
-                break;
-                }
-            }
-
-            // Apply gain after distortion
-            channelData[sample] = distortedSample * currentGain;
+            syncedDivision = -1;
+            blockDelaySamples = delaySettings.timeSamples;
+            delayRampsOverBlock = false;
         }
     }
 
-    // Process delay
-    if (delayMix > 0.0f)
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    auto inputBlock = block.getSubsetChannelBlock(0, (size_t)totalNumInputChannels);
+
+    // Metering and analysis only run while an editor is reading them
+    metering = meterFeed.isActive();
+    const bool analysing = spectrumAnalyser.isActive();
+    stages.delay.setTapMetering(metering);
+
+    // Nothing to do while the chain is idle and the input stays silent, as long
+    // as a delay brought back in since then has nothing of its own to play
+    const bool delayActive = delaySettings.mix > 0.0f || stages.delay.isSmoothing();
+    const bool inputSilent = isBelowSilenceFloor(inputBlock);
+    const bool delaySilent = ! delayActive || stages.delay.isSilent();
+
+    if (idle && inputSilent && delaySilent)
     {
-        // Calculate delay in samples
-        int delaySamples = (int)(delayTime * currentSampleRate);
+        if (metering)
+            meterFeed.measure(MeterFeed::input, inputBlock);
 
-        // For simple stereo processing
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        if (analysing)
+            spectrumAnalyser.push(SpectrumAnalyser::input, inputBlock);
+
+        inputBlock.clear();
+        stages.compressor.skipSilence(numSamples);
+        stages.delay.clearStale(delayClearPerBlock);
+        subBlockPhase = (subBlockPhase + numSamples) % subBlockSize;
+
+        if (metering)
         {
-            auto* channelData = buffer.getWritePointer(channel);
+            meterFeed.measure(MeterFeed::output, inputBlock);
+            meterFeed.publish();
+        }
+
+        if (analysing)
+            spectrumAnalyser.push(SpectrumAnalyser::output, inputBlock);
+
+        return;
+    }
+
+    // Whatever of the delay's stale history the idle blocks didn't get to goes
+    // now, before writing moves it along
+    if (idle)
+        stages.delay.clearStale(std::numeric_limits<int>::max());
+
+    idle = false;
+
+    const auto order = (int)chainOrderValue->load();
+
+    // Take each sub-block through the whole chain, taps included, while it's in cache
+    for (int start = 0; start < numSamples;)
+    {
+        const auto length = juce::jmin(numSamples - start, subBlockSize - subBlockPhase);
+        auto subBlock = inputBlock.getSubBlock((size_t)start, (size_t)length);
+        samplesLeftInBlock = numSamples - start;
+
+        if (metering)
+            meterFeed.measure(MeterFeed::input, subBlock);
+
+        if (analysing)
+            spectrumAnalyser.push(SpectrumAnalyser::input, subBlock);
+
+        // One call into the chosen order, which runs every slot without further dispatch
+        Chain<SampleType>::process(*this, order, subBlock);
+
+        if (metering)
+            meterFeed.measure(MeterFeed::output, subBlock);
+
+        if (analysing)
+            spectrumAnalyser.push(SpectrumAnalyser::output, subBlock);
+
+        start += length;
+        subBlockPhase = (subBlockPhase + length) % subBlockSize;
+    }
+
+    if (metering)
+        meterFeed.publish();
+
+    // Count the silence, going idle once it has outlasted every tail. The block holds the output by now.
+    if (inputSilent && (! delayActive || stages.delay.isSilent()) && isBelowSilenceFloor(inputBlock))
+    {
+        quietSamples = juce::jmin(quietSamples + numSamples, std::numeric_limits<int>::max() / 2);
+        const auto tailSeconds = getStageTailSeconds(stages.modulation.isActive(), stages.reverb.isActive(), convolution.getTailSamples());
+        idle = quietSamples >= (int)std::ceil(tailSeconds * currentSampleRate);
+
+        // Nothing is written to the delay while idle, so whatever it still holds
+        // would come back out of it later. Only what was written before it went
+        // quiet matters, and the idle blocks clear that a piece at a time.
+        if (idle)
+            stages.delay.forgetStale();
+    }
+    else
+    {
+        quietSamples = 0;
+    }
+}
 
-            // Process each sample
-            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-            {
-                // Get the current sample
-                const float in = channelData[sample];
+template <typename SampleType>
+bool _3ff3ctsAudioProcessor::isBelowSilenceFloor(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto floor = juce::Decibels::decibelsToGain(silenceFloorDb);
 
-                // Calculate read position
-                int readPosition = delayWritePosition - delaySamples;
-                if (readPosition < 0)
-                    readPosition += delayBufferLength;
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(channel), (int)block.getNumSamples());
 
-                // Get delayed sample
-                float delayed = delayBuffer[readPosition];
+        if (range.getStart() < -floor || range.getEnd() > floor)
+            return false;
+    }
 
-                // Write to delay buffer (input + feedback)
-                delayBuffer[delayWritePosition] = in + delayed * delayFeedback;
+    return true;
+}
+
+double _3ff3ctsAudioProcessor::getStageTailSeconds(bool withModulation, bool withReverb, int convolutionTailSamples) const
+{
+    // The look-ahead and oversampling filters hold the latency's worth of
+    // samples, and the linear-phase filters ring for as long again
+    auto samples = 2.0 * getLatencySamples() + convolutionTailSamples;
+    auto seconds = 0.0;
+
+    if (withModulation)
+        seconds += ModulationStage<float>::getTailSeconds((ModulationStage<float>::Mode)(int)modulationModeValue->load(), modulationDepthValue->load(),
+                                                          modulationFeedbackValue->load(), silenceFloorDb);
 
-                // Increment and wrap write position
-                delayWritePosition++;
-                if (delayWritePosition >= delayBufferLength)
-                    delayWritePosition = 0;
+    if (withReverb)
+        seconds += FdnReverb<float>::getTailSeconds(reverbSizeValue->load(), reverbDecayValue->load(), silenceFloorDb);
 
-                // Mix dry/wet
-                channelData[sample] = in * (1.0f - delayMix) + delayed * delayMix;
-            }
+    // The stages' tails follow one another, whatever the order
+    return samples / currentSampleRate + seconds;
+}
+
+template <int slot, typename SampleType>
+void _3ff3ctsAudioProcessor::processSlot(juce::dsp::AudioBlock<SampleType>& block)
+{
+    auto& stages = getStages<SampleType>();
+
+    if constexpr (slot == driveSlot)
+    {
+        // Compressor ahead of the drive, so it evens out what the shaper sees
+        if (stages.compressor.isEnabled())
+            stages.compressor.process(block);
+
+        stages.distortion.process(block);
+
+        if (metering)
+            meterFeed.measure(MeterFeed::distorted, block);
+
+        // Cabinet/room IR, kept running while a new one crossfades in or an old one out
+        if (convolution.isActive())
+            convolution.process(block);
+    }
+    else if constexpr (slot == modulationSlot)
+    {
+        // Chorus/flanger/phaser, left running while its mix fades out
+        if (stages.modulation.isActive())
+            stages.modulation.process(block);
+    }
+    else if constexpr (slot == delaySlot)
+    {
+        // Process delay, letting it run on while the mix fades out
+        if (delaySettings.mix > 0.0f || stages.delay.isSmoothing())
+        {
+            // A tempo-synced time lands at the end of the host's block, not this sub-block
+            stages.delay.process(block, blockDelaySamples, delaySettings.feedback, delaySettings.mix,
+                                 delayRampsOverBlock ? samplesLeftInBlock : 0);
+
+            if (metering)
+                for (int channel = 0; channel < juce::jmin((int)block.getNumChannels(), stages.delay.getNumChannels()); ++channel)
+                    meterFeed.setDelayTapPeak(channel, stages.delay.getTapPeak(channel));
         }
     }
+    else if constexpr (slot == reverbSlot)
+    {
+        // Reverb, also left running while its mix fades out
+        if (stages.reverb.isActive())
+            stages.reverb.process(block);
+    }
+    else
+    {
+        static_assert(slot < numChainSlots, "Every slot needs its stages here");
+    }
+}
+
+template <typename SampleType>
+void _3ff3ctsAudioProcessor::updateCompressorSettings()
+{
+    getStages<SampleType>().compressor.setParameters(compressorEnabledValue->load() >= 0.5f,
+                                                     compressorThresholdValue->load(),
+                                                     compressorRatioValue->load(),
+                                                     compressorAttackValue->load(),
+                                                     compressorReleaseValue->load(),
+                                                     compressorLookaheadValue->load(),
+                                                     compressorMakeupValue->load());
+}
+
+float _3ff3ctsAudioProcessor::getCompressorGainReductionDb() const
+{
+    if (isUsingDoublePrecision())
+        return getStages<double>().compressor.getGainReductionDb();
+
+    return getStages<float>().compressor.getGainReductionDb();
+}
+
+void _3ff3ctsAudioProcessor::updateSyncedDelay(int division)
+{
+    // Hosts without a play head, or without a tempo, keep the last tempo we saw
+    double bpm = hostBpm.load();
+
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto positionBpm = position->getBpm())
+                bpm = *positionBpm;
+
+    if (bpm == hostBpm.load() && division == syncedDivision)
+        return;
+
+    hostBpm.store(bpm);
+    syncedDivision = division;
+    syncedDelaySamples = (float)(TempoSync::getDelaySeconds(division, bpm) * currentSampleRate);
 }
 
 bool _3ff3ctsAudioProcessor::hasEditor() const
@@ -269,7 +861,29 @@ void _3ff3ctsAudioProcessor::setStateInformation(const void* data, int sizeInByt
 
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+            // Sessions saved without an IR, or before the convolution stage, clear it
+            const auto path = apvts.state.getProperty(impulseResponseProperty).toString();
+
+            if (path.isNotEmpty())
+                convolution.load(juce::File(path));
+            else
+                convolution.unload();
+        }
+}
+
+void _3ff3ctsAudioProcessor::loadImpulseResponse(const juce::File& file)
+{
+    apvts.state.setProperty(impulseResponseProperty, file.getFullPathName(), nullptr);
+    convolution.load(file);
+}
+
+void _3ff3ctsAudioProcessor::clearImpulseResponse()
+{
+    apvts.state.removeProperty(impulseResponseProperty, nullptr);
+    convolution.unload();
 }
 
 const juce::String _3ff3ctsAudioProcessor::getName() const
@@ -306,8 +920,21 @@ bool _3ff3ctsAudioProcessor::isMidiEffect() const
 
 double _3ff3ctsAudioProcessor::getTailLengthSeconds() const
 {
-    // Return a longer tail length to accommodate delay
-    return delayTimeParameter->get() * 5.0;
+    // Until a full-scale signal has died away below the silence floor, from the
+    // current settings: the same sum of tails the idle short-circuit waits for
+    const auto convolutionTail = convolutionMixValue->load() > 0.0f ? convolution.getLoadedLength() : 0;
+    auto tail = getStageTailSeconds(modulationMixValue->load() > 0.0f, reverbMixValue->load() > 0.0f, convolutionTail);
+
+    if (delayMixValue->load() > 0.0f)
+    {
+        const auto delaySeconds = delaySyncValue->load() >= 0.5f
+                                    ? TempoSync::getDelaySeconds((int)delayDivisionValue->load(), hostBpm.load())
+                                    : (double)delayTimeValue->load();
+
+        tail += MultiChannelDelay<float>::getTailLength(delaySeconds, delayFeedbackValue->load(), silenceFloorDb);
+    }
+
+    return tail;
 }
 
 int _3ff3ctsAudioProcessor::getNumPrograms()
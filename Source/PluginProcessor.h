@@ -1,8 +1,22 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DSP/LookaheadCompressor.h"
+#include "DSP/DistortionStage.h"
+#include "DSP/MultiChannelDelay.h"
+#include "DSP/FdnReverb.h"
+#include "DSP/ConvolutionStage.h"
+#include "DSP/ModulationStage.h"
+#include "DSP/TempoSync.h"
+#include "DSP/EffectChain.h"
+#include "DSP/DspArena.h"
+#include "Analysis/MeterFeed.h"
+#include "Analysis/SpectrumAnalyser.h"
+#include "Debug/RealtimeSafety.h"
 
-class _3ff3ctsAudioProcessor : public juce::AudioProcessor
+class _3ff3ctsAudioProcessor : public juce::AudioProcessor,
+                               private juce::AudioProcessorValueTreeState::Listener,
+                               private juce::Timer
 {
 public:
     _3ff3ctsAudioProcessor();
@@ -16,6 +30,8 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -39,26 +55,235 @@ public:
     // Access to parameters
     juce::AudioProcessorValueTreeState& getParameters() { return apvts; }
 
-private:
-    // Distortion parameters
-    juce::AudioParameterFloat* gainParameter;
-    juce::AudioParameterFloat* distortionParameter;
-    juce::AudioParameterChoice* distortionTypeParameter;
+    // Levels and scope trace for the editor, published from processBlock
+    MeterFeed& getMeterFeed() { return meterFeed; }
+
+    // Input/output spectrum, analysed off the audio thread while the editor shows it
+    SpectrumAnalyser& getSpectrumAnalyser() { return spectrumAnalyser; }
+
+    // Gain reduction for the editor's meter, in dB
+    float getCompressorGainReductionDb() const;
+
+    // Impulse response for the convolution stage. The file's path is kept in the
+    // plugin state, and loading carries on in the background after these return.
+    void loadImpulseResponse(const juce::File& file);
+    void clearImpulseResponse();
+    ConvolutionStage::Status getImpulseResponseStatus() const { return convolution.getStatus(); }
 
-    // Delay parameters
-    juce::AudioParameterFloat* delayTimeParameter;
-    juce::AudioParameterFloat* delayFeedbackParameter;
-    juce::AudioParameterFloat* delayMixParameter;
+    // The chainOrder parameter's choices, such as "Drive > Mod > Delay > Reverb"
+    static juce::StringArray getChainOrderNames();
 
+private:
     // Parameter storage
     juce::AudioProcessorValueTreeState apvts;
 
-    // Delay line buffer
-    std::vector<float> delayBuffer;
-    int delayBufferLength = 0;
-    int delayWritePosition = 0;
+    // Raw parameter values, read lock-free on the audio thread.
+    // Choices hold their index and switches 0 or 1.
+    std::atomic<float>* compressorEnabledValue = nullptr;
+    std::atomic<float>* compressorThresholdValue = nullptr;
+    std::atomic<float>* compressorRatioValue = nullptr;
+    std::atomic<float>* compressorAttackValue = nullptr;
+    std::atomic<float>* compressorReleaseValue = nullptr;
+    std::atomic<float>* compressorLookaheadValue = nullptr;
+    std::atomic<float>* compressorMakeupValue = nullptr;
+
+    std::atomic<float>* gainValue = nullptr;
+    std::atomic<float>* distortionValue = nullptr;
+    std::atomic<float>* distortionTypeValue = nullptr;
+    std::atomic<float>* oversamplingValue = nullptr;
+    std::atomic<float>* antiAliasingValue = nullptr;
+
+    std::atomic<float>* modulationModeValue = nullptr;
+    std::atomic<float>* modulationRateValue = nullptr;
+    std::atomic<float>* modulationDepthValue = nullptr;
+    std::atomic<float>* modulationFeedbackValue = nullptr;
+    std::atomic<float>* modulationMixValue = nullptr;
+
+    std::atomic<float>* delayTimeValue = nullptr;
+    std::atomic<float>* delayFeedbackValue = nullptr;
+    std::atomic<float>* delayMixValue = nullptr;
+    std::atomic<float>* delayInterpolationValue = nullptr;
+    std::atomic<float>* delaySyncValue = nullptr;
+    std::atomic<float>* delayDivisionValue = nullptr;
+
+    std::atomic<float>* reverbSizeValue = nullptr;
+    std::atomic<float>* reverbDecayValue = nullptr;
+    std::atomic<float>* reverbDampingValue = nullptr;
+    std::atomic<float>* reverbMixValue = nullptr;
+
+    std::atomic<float>* convolutionMixValue = nullptr;
+
+    std::atomic<float>* chainOrderValue = nullptr;
+
+    // Raised by parameterChanged() so processBlock only re-derives settings
+    // for the stage whose parameters moved. All start raised.
+    std::atomic<bool> compressorSettingsChanged { true };
+    std::atomic<bool> distortionSettingsChanged { true };
+    std::atomic<bool> modulationSettingsChanged { true };
+    std::atomic<bool> delaySettingsChanged { true };
+    std::atomic<bool> reverbSettingsChanged { true };
+    std::atomic<bool> convolutionSettingsChanged { true };
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    // Tells the host the latency of the current look-ahead, oversampling and
+    // ADAA settings. Message thread only: the host notification takes locks.
+    void updateLatency();
+
+    // Top of the free delay time range; longer times need sync
+    static constexpr float maxDelayTimeSeconds = 1.0f;
+
+    // State property holding the loaded impulse response's full path
+    static constexpr const char* impulseResponseProperty = "impulseResponse";
+
+    // Delay settings as of the last change; the delay smooths towards them
+    struct DelaySettings
+    {
+        float timeSamples = 0.0f;
+        float feedback = 0.0f;
+        float mix = 0.0f;
+        int division = TempoSync::defaultDivision;
+        bool sync = false;
+    };
+
+    DelaySettings delaySettings;
+
+    // The stages that run at the host's precision. There's a set for each;
+    // prepareToPlay prepares the one the host has chosen, and the same code
+    // drives either through the templates below.
+    template <typename SampleType>
+    struct Stages
+    {
+        // Compressor/limiter in front of the distortion, skipped while switched off
+        LookaheadCompressor<SampleType> compressor;
+
+        // Distortion engine
+        DistortionStage<SampleType> distortion;
+
+        // Chorus, flanger or phaser, skipped while its mix is at zero
+        ModulationStage<SampleType> modulation;
+
+        // Delay line, one ring per channel
+        MultiChannelDelay<SampleType> delay;
+
+        // Reverb, skipped while its mix is at zero
+        FdnReverb<SampleType> reverb;
+    };
+
+    std::tuple<Stages<float>, Stages<double>> stageSets;
+
+    template <typename SampleType>
+    Stages<SampleType>& getStages() noexcept { return std::get<Stages<SampleType>>(stageSets); }
+
+    template <typename SampleType>
+    const Stages<SampleType>& getStages() const noexcept { return std::get<Stages<SampleType>>(stageSets); }
+
+    template <typename SampleType>
+    void prepareStages(const juce::dsp::ProcessSpec& spec);
+
+    // Both processBlock overloads come here, with the matching set of stages
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    void updateCompressorSettings();
+
+    // Cabinet or room IR straight after the distortion, skipped while none is
+    // loaded. It runs in float at either precision.
+    ConvolutionStage convolution;
+
     double currentSampleRate = 44100.0;
 
+    // Tempo-synced delay, recomputed only when the tempo or division changes.
+    // The tempo is also read by getTailLengthSeconds().
+    std::atomic<double> hostBpm { TempoSync::fallbackBpm };
+    int syncedDivision = -1;
+    float syncedDelaySamples = 0.0f;
+
+    // The delay time processBlock worked out for the whole host block, and
+    // whether it should be reached exactly at the block's end
+    float blockDelaySamples = 0.0f;
+    bool delayRampsOverBlock = false;
+
+    void updateSyncedDelay(int division);
+
+    // The effects, in groups that the chainOrder parameter can put in any order.
+    // Drive is the compressor, distortion and IR, which always run together.
+    enum ChainSlot
+    {
+        driveSlot = 0,
+        modulationSlot,
+        delaySlot,
+        reverbSlot,
+        numChainSlots
+    };
+
+    template <typename SampleType>
+    using Chain = EffectChain<_3ff3ctsAudioProcessor, SampleType, numChainSlots>;
+    friend Chain<float>;
+    friend Chain<double>;
+
+    // Runs one slot's stages over the block; Chain calls these in the chosen order
+    template <int slot, typename SampleType>
+    void processSlot(juce::dsp::AudioBlock<SampleType>& block);
+
+    bool metering = false;   // whether this block feeds the editor's meters
+
+    // The compressor's, modulation's, delay's and reverb's memory, in one block
+    // laid out in prepareToPlay and given back in releaseResources (see DspArena).
+    // A stage's section is only claimed once the stage is in use, and the stage
+    // is skipped until the audio thread has picked its section up.
+    enum ArenaSection
+    {
+        compressorSection = 0,
+        modulationSection,
+        delaySection,
+        reverbSection
+    };
+
+    static constexpr int arenaPollHz = 20;
+
+    DspArena arena;
+    juce::CriticalSection arenaLock;
+    size_t arenaSampleSize = sizeof(float);   // of the stage set it was laid out for
+
+    void claimArenaSections();    // never on the audio thread, except offline
+
+    template <typename SampleType>
+    void attachArenaSections();   // audio thread, or while it's stopped
+    void timerCallback() override;
+
+    // The chain runs over each host block in sub-blocks of at most subBlockSize
+    // samples, each going through every stage while it's still in cache. The
+    // sub-blocks fall on a fixed grid over the stream, so however the host
+    // splits it into blocks, the stages see the same cuts away from the block edges.
+    static constexpr int subBlockSize = 64;
+    int subBlockPhase = 0;        // samples into the current grid cell
+    int samplesLeftInBlock = 0;   // from the current sub-block's start to the host block's end
+
+    // Idle short-circuit. Once the input and output have stayed below the
+    // silence floor for longer than the stages' tails, with nothing left in the
+    // delay to echo, the output stays silent until the input comes back, and
+    // processBlock skips the chain until then.
+    static constexpr float silenceFloorDb = -96.0f;   // the quietest step of 16-bit audio
+    int quietSamples = 0;
+    bool idle = false;
+
+    // Delay samples zeroed per idle block, so a long ring is cleared over many
+    // blocks rather than in one
+    static constexpr int delayClearPerBlock = 8192;
+
+    template <typename SampleType>
+    static bool isBelowSilenceFloor(const juce::dsp::AudioBlock<SampleType>& block) noexcept;
+
+    // How long the chain can keep sounding once its input falls silent, with
+    // the stages given. The delay is left out: the audio thread tracks it
+    // exactly, and getTailLengthSeconds() adds it from the settings.
+    double getStageTailSeconds(bool withModulation, bool withReverb, int convolutionTailSamples) const;
+
+    MeterFeed meterFeed;
+    SpectrumAnalyser spectrumAnalyser;
+
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(_3ff3ctsAudioProcessor)
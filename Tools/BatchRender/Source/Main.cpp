@@ -0,0 +1,281 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/OfflineHost.h"
+
+// Renders audio files through the plugin with no DAW.
+//
+//   BatchRender --state <file> --out <dir> [--threads N] [--block N]
+//               [--bpm N] [--tail seconds] <input files...>
+//   BatchRender --dump-state <file>
+//
+// Every worker thread owns one processor, loaded with the same saved state
+// (the blob getStateInformation produces; --dump-state writes the defaults),
+// and pulls files off a shared list until it's empty. Output keeps the input's
+// name, format, channel count and bit depth, is aligned for the plugin's
+// latency, and can be extended with a tail for delay repeats.
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::MemoryBlock state;
+        juce::File outputDirectory;
+        int blockSize = 512;
+        double bpm = TempoSync::fallbackBpm;
+        double tailSeconds = 0.0;
+    };
+
+    juce::CriticalSection consoleLock;
+
+    void printLine(const juce::String& line)
+    {
+        const juce::ScopedLock lock(consoleLock);
+        std::cout << line << std::endl;
+    }
+
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker(std::unique_ptr<_3ff3ctsAudioProcessor> processorToUse,
+                     const RenderSettings& settingsToUse,
+                     const juce::Array<juce::File>& filesToRender,
+                     std::atomic<int>& sharedNextFile,
+                     std::atomic<int>& sharedFailures)
+            : juce::ThreadPoolJob("Render worker"),
+              processor(std::move(processorToUse)),
+              settings(settingsToUse),
+              files(filesToRender),
+              nextFile(sharedNextFile),
+              failures(sharedFailures),
+              playHead(settingsToUse.bpm)
+        {
+            formatManager.registerBasicFormats();
+            processor->setPlayHead(&playHead);
+            processor->setNonRealtime(true);
+        }
+
+        JobStatus runJob() override
+        {
+            for (int index = nextFile++; index < files.size(); index = nextFile++)
+            {
+                if (shouldExit())
+                    break;
+
+                juce::String error;
+
+                if (! render(files.getReference(index), error))
+                {
+                    ++failures;
+                    printLine(files.getReference(index).getFileName() + ": FAILED, " + error);
+                }
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        bool render(const juce::File& input, juce::String& error)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+            if (reader == nullptr)
+            {
+                error = "unreadable or unsupported format";
+                return false;
+            }
+
+            const auto numChannels = (int)reader->numChannels;
+            const auto sampleRate = reader->sampleRate;
+            const auto blockSize = settings.blockSize;
+
+            if (! OfflineHost::prepare(*processor, numChannels, sampleRate, blockSize))
+            {
+                error = juce::String(numChannels) + " channel files aren't supported";
+                return false;
+            }
+
+            // Every file starts with the IR in place, never dry with it fading in
+            while (processor->getImpulseResponseStatus().state == ConvolutionStage::State::loading)
+                juce::Thread::sleep(5);
+
+            auto* format = formatManager.findFormatForFileExtension(input.getFileExtension());
+            const auto output = settings.outputDirectory.getChildFile(input.getFileName());
+            output.deleteFile();
+
+            std::unique_ptr<juce::OutputStream> stream(output.createOutputStream());
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+
+            if (format != nullptr && stream != nullptr)
+            {
+                writer.reset(format->createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels,
+                                                     (int)reader->bitsPerSample, reader->metadataValues, 0));
+
+                if (writer != nullptr)
+                    stream.release();   // the writer owns it now
+            }
+
+            if (writer == nullptr)
+            {
+                error = "couldn't create " + output.getFullPathName();
+                return false;
+            }
+
+            // The output is delayed by the plugin's latency, so drop that much from
+            // the start and run the same amount of silence through at the end
+            const auto latency = (juce::int64)processor->getLatencySamples();
+            const auto tail = (juce::int64)std::ceil(settings.tailSeconds * sampleRate);
+            const auto inputLength = reader->lengthInSamples;
+            const auto totalLength = inputLength + tail + latency;
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::MidiBuffer midi;
+            playHead.setSampleRate(sampleRate);
+            playHead.rewind();
+
+            const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+            for (juce::int64 position = 0; position < totalLength; position += blockSize)
+            {
+                const auto numSamples = (int)juce::jmin((juce::int64)blockSize, totalLength - position);
+                buffer.setSize(numChannels, numSamples, false, false, true);
+
+                // Past the end of the file the reader pads with silence
+                reader->read(&buffer, 0, numSamples, position, true, true);
+
+                processor->processBlock(buffer, midi);
+                midi.clear();
+                playHead.advance(numSamples);
+
+                const auto skip = (int)juce::jlimit((juce::int64)0, (juce::int64)numSamples, latency - position);
+
+                if (skip < numSamples)
+                    writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+            }
+
+            writer.reset();
+            processor->releaseResources();
+
+            const auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            const auto audioSeconds = (double)inputLength / sampleRate;
+
+            printLine(input.getFileName() + ": " + juce::String(audioSeconds, 2) + " s in "
+                      + juce::String(seconds, 3) + " s, "
+                      + juce::String(audioSeconds / juce::jmax(seconds, 1.0e-9), 1) + "x realtime");
+            return true;
+        }
+
+        std::unique_ptr<_3ff3ctsAudioProcessor> processor;
+        const RenderSettings& settings;
+        const juce::Array<juce::File>& files;
+        std::atomic<int>& nextFile;
+        std::atomic<int>& failures;
+        OfflineHost::FixedTempoPlayHead playHead;
+        juce::AudioFormatManager formatManager;
+    };
+
+    int printUsage()
+    {
+        printLine("usage: BatchRender --state <file> --out <dir> [--threads N] [--block N] [--bpm N] [--tail seconds] <files...>");
+        printLine("       BatchRender --dump-state <file>");
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Processors are built on this thread, which acts as the message thread
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--dump-state"))
+    {
+        _3ff3ctsAudioProcessor processor;
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+
+        return args.getFileForOption("--dump-state").replaceWithData(state.getData(), state.getSize()) ? 0 : 1;
+    }
+
+    RenderSettings settings;
+
+    if (! args.containsOption("--state") || ! args.containsOption("--out"))
+        return printUsage();
+
+    settings.state = OfflineHost::loadState(args.getFileForOption("--state"));
+    settings.outputDirectory = args.getFileForOption("--out");
+
+    if (settings.state.isEmpty())
+    {
+        printLine("couldn't read the state file");
+        return 1;
+    }
+
+    if (! settings.outputDirectory.createDirectory())
+    {
+        printLine("couldn't create " + settings.outputDirectory.getFullPathName());
+        return 1;
+    }
+
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(16, 8192, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--bpm"))
+        settings.bpm = juce::jmax(TempoSync::minBpm, args.getValueForOption("--bpm").getDoubleValue());
+
+    if (args.containsOption("--tail"))
+        settings.tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+    int numThreads = juce::SystemStats::getNumCpus();
+
+    if (args.containsOption("--threads"))
+        numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    // Everything that isn't an option or an option's value is an input file
+    juce::Array<juce::File> files;
+    const juce::StringArray valueOptions = { "--state", "--out", "--threads", "--block", "--bpm", "--tail" };
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        if (valueOptions.contains(args[i].text))
+        {
+            ++i;
+            continue;
+        }
+
+        if (args[i].isOption())
+            continue;
+
+        files.add(args[i].resolveAsFile());
+    }
+
+    if (files.isEmpty())
+        return printUsage();
+
+    numThreads = juce::jmin(numThreads, files.size());
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<int> failures { 0 };
+    juce::OwnedArray<RenderWorker> workers;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto processor = std::make_unique<_3ff3ctsAudioProcessor>();
+        processor->setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+        workers.add(new RenderWorker(std::move(processor), settings, files, nextFile, failures));
+    }
+
+    juce::ThreadPool pool(juce::ThreadPoolOptions{}.withThreadName("Render").withNumberOfThreads(numThreads));
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto* worker : workers)
+        pool.addJob(worker, false);
+
+    for (auto* worker : workers)
+        pool.waitForJobToFinish(worker, -1);
+
+    const auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    printLine(juce::String(files.size() - failures.load()) + " of " + juce::String(files.size())
+              + " files rendered in " + juce::String(seconds, 2) + " s on " + juce::String(numThreads) + " threads");
+
+    return failures.load() == 0 ? 0 : 1;
+}
\ No newline at end of file
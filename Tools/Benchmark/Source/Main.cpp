@@ -0,0 +1,282 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/DSP/ShaperKernels.h"
+#include "../../Common/OfflineHost.h"
+
+// Times processBlock across distortion types, delay on/off, block sizes,
+// sample rates and channel counts, and writes the results as JSON.
+//
+//   Benchmark [--out results.json] [--baseline old.json] [--tolerance percent]
+//             [--label text] [--seconds N] [--quick]
+//             [--blocks 16,64,...] [--rates 44100,...] [--channels 1,2] [--double]
+//
+// Each configuration is warmed up, then timed over --seconds of audio
+// (default 0.25) several times; the fastest run is kept as the least disturbed
+// by the rest of the machine. nsPerSample is per sample frame, all channels.
+// --double runs the processor at double precision, as a host asking for it
+// would; those configurations get their own keys.
+// With --baseline, every configuration is compared against the matching entry
+// and the exit code is 1 if any got slower by more than --tolerance (default 10).
+// A --channels count the processor won't take is skipped with an error, and
+// also makes the exit code 1.
+// Progress and the comparison go to stderr, so stdout is only the JSON.
+
+namespace
+{
+    constexpr int numRepeats = 5;
+
+    struct Config
+    {
+        int type = 0;
+        bool delay = false;
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int channels = 2;
+        bool doublePrecision = false;
+
+        juce::String getKey() const
+        {
+            return juce::String(type) + "/" + (delay ? "delay" : "dry") + "/" + juce::String(blockSize)
+                   + "/" + juce::String((int)sampleRate) + "/" + juce::String(channels)
+                   + (doublePrecision ? "/double" : "");
+        }
+    };
+
+    struct Result
+    {
+        Config config;
+        double nsPerSample = 0.0;
+        double realtimeFactor = 0.0;
+    };
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& id, float value)
+    {
+        if (auto* parameter = apvts.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // Nothing if the processor doesn't take the configuration's channel count
+    template <typename SampleType>
+    std::optional<Result> run(_3ff3ctsAudioProcessor& processor, const Config& config, double secondsPerRun)
+    {
+        auto& apvts = processor.getParameters();
+        setParameter(apvts, "distortionType", (float)config.type);
+        setParameter(apvts, "distortion", 0.5f);
+        setParameter(apvts, "delayMix", config.delay ? 0.5f : 0.0f);
+
+        if (! OfflineHost::prepare(processor, config.channels, config.sampleRate, config.blockSize, config.doublePrecision))
+            return {};
+
+        // -12 dB noise, generated up front so only the processor is timed
+        const int numBlocks = juce::jmax(1, (int)(secondsPerRun * config.sampleRate) / config.blockSize);
+        juce::AudioBuffer<SampleType> source(config.channels, config.blockSize * 8);
+        juce::Random random(1);
+
+        for (int channel = 0; channel < source.getNumChannels(); ++channel)
+            for (int sample = 0; sample < source.getNumSamples(); ++sample)
+                source.setSample(channel, sample, (SampleType)((random.nextFloat() * 2.0f - 1.0f) * 0.25f));
+
+        juce::AudioBuffer<SampleType> buffer(config.channels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        const auto processBlocks = [&](int count)
+        {
+            for (int block = 0; block < count; ++block)
+            {
+                const auto offset = (block % 8) * config.blockSize;
+
+                for (int channel = 0; channel < config.channels; ++channel)
+                    buffer.copyFrom(channel, 0, source, channel, offset, config.blockSize);
+
+                processor.processBlock(buffer, midi);
+            }
+        };
+
+        // Let parameter ramps settle and caches warm up before timing
+        processBlocks(juce::jmax(8, (int)(0.2 * config.sampleRate) / config.blockSize));
+
+        double bestSeconds = std::numeric_limits<double>::max();
+
+        for (int repeat = 0; repeat < numRepeats; ++repeat)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            processBlocks(numBlocks);
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            bestSeconds = juce::jmin(bestSeconds, elapsed);
+        }
+
+        processor.releaseResources();
+
+        const auto numSamples = (double)numBlocks * config.blockSize;
+
+        Result result;
+        result.config = config;
+        result.nsPerSample = bestSeconds * 1.0e9 / numSamples;
+        result.realtimeFactor = (numSamples / config.sampleRate) / juce::jmax(bestSeconds, 1.0e-12);
+        return result;
+    }
+
+    juce::Array<int> parseIntList(const juce::String& text)
+    {
+        juce::Array<int> values;
+
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            if (token.trim().isNotEmpty())
+                values.add(token.trim().getIntValue());
+
+        return values;
+    }
+
+    juce::var toJson(const Result& result, const juce::StringArray& typeNames)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("key", result.config.getKey());
+        object->setProperty("type", typeNames[result.config.type]);
+        object->setProperty("delay", result.config.delay);
+        object->setProperty("blockSize", result.config.blockSize);
+        object->setProperty("sampleRate", result.config.sampleRate);
+        object->setProperty("channels", result.config.channels);
+        object->setProperty("precision", result.config.doublePrecision ? "double" : "float");
+        object->setProperty("nsPerSample", result.nsPerSample);
+        object->setProperty("realtimeFactor", result.realtimeFactor);
+        return juce::var(object);
+    }
+
+    // Prints every configuration against the baseline; returns how many regressed
+    int compareWithBaseline(const juce::Array<Result>& results, const juce::var& baseline, double tolerancePercent)
+    {
+        std::map<juce::String, double> baselineTimes;
+
+        if (auto* entries = baseline["results"].getArray())
+            for (auto& entry : *entries)
+                baselineTimes[entry["key"].toString()] = (double)entry["nsPerSample"];
+
+        int regressions = 0, compared = 0;
+
+        for (auto& result : results)
+        {
+            const auto found = baselineTimes.find(result.config.getKey());
+
+            if (found == baselineTimes.end() || found->second <= 0.0)
+                continue;
+
+            ++compared;
+            const auto change = (result.nsPerSample / found->second - 1.0) * 100.0;
+            const bool regressed = change > tolerancePercent;
+            regressions += regressed ? 1 : 0;
+
+            std::cerr << result.config.getKey() << ": " << juce::String(found->second, 2) << " -> "
+                      << juce::String(result.nsPerSample, 2) << " ns/sample ("
+                      << (change >= 0.0 ? "+" : "") << juce::String(change, 1) << "%)"
+                      << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+
+        std::cerr << compared << " configurations compared with " << baseline["label"].toString() << ", "
+                  << regressions << " slower by more than " << tolerancePercent << "%" << std::endl;
+
+        return regressions;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    const bool quick = args.containsOption("--quick");
+    const bool doublePrecision = args.containsOption("--double");
+
+    auto blockSizes = quick ? juce::Array<int>{ 64, 512 } : juce::Array<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    auto sampleRates = quick ? juce::Array<int>{ 48000 } : juce::Array<int>{ 44100, 48000, 88200, 96000, 192000 };
+    auto channelCounts = quick ? juce::Array<int>{ 2 } : juce::Array<int>{ 1, 2 };
+
+    if (args.containsOption("--blocks"))
+        blockSizes = parseIntList(args.getValueForOption("--blocks"));
+
+    if (args.containsOption("--rates"))
+        sampleRates = parseIntList(args.getValueForOption("--rates"));
+
+    if (args.containsOption("--channels"))
+        channelCounts = parseIntList(args.getValueForOption("--channels"));
+
+    const auto secondsPerRun = args.containsOption("--seconds")
+                                   ? juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue())
+                                   : 0.25;
+
+    _3ff3ctsAudioProcessor processor;
+
+    const auto typeNames = dynamic_cast<juce::AudioParameterChoice*>(processor.getParameters().getParameter("distortionType"))->choices;
+
+    juce::Array<Result> results;
+    int numSkipped = 0;
+
+    for (int type = 0; type < typeNames.size(); ++type)
+        for (bool delay : { false, true })
+            for (auto channels : channelCounts)
+                for (auto sampleRate : sampleRates)
+                    for (auto blockSize : blockSizes)
+                    {
+                        Config config;
+                        config.type = type;
+                        config.delay = delay;
+                        config.blockSize = blockSize;
+                        config.sampleRate = (double)sampleRate;
+                        config.channels = channels;
+                        config.doublePrecision = doublePrecision;
+
+                        const auto result = doublePrecision ? run<double>(processor, config, secondsPerRun)
+                                                            : run<float>(processor, config, secondsPerRun);
+
+                        if (! result.has_value())
+                        {
+                            std::cerr << config.getKey() << ": skipped, the processor doesn't take " << channels << " channels" << std::endl;
+                            ++numSkipped;
+                            continue;
+                        }
+
+                        results.add(*result);
+
+                        std::cerr << config.getKey() << ": " << juce::String(result->nsPerSample, 2) << " ns/sample, "
+                                  << juce::String(result->realtimeFactor, 0) << "x realtime" << std::endl;
+                    }
+
+    // Machine-readable results, with enough context to know what was measured
+    auto* root = new juce::DynamicObject();
+    root->setProperty("label", args.containsOption("--label") ? args.getValueForOption("--label") : juce::String("unlabelled"));
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty("shaperKernel", juce::String(ShaperKernels::getBestKernel().name));
+    root->setProperty("secondsPerRun", secondsPerRun);
+
+    juce::Array<juce::var> entries;
+
+    for (auto& result : results)
+        entries.add(toJson(result, typeNames));
+
+    root->setProperty("results", entries);
+
+    const auto json = juce::JSON::toString(juce::var(root));
+
+    if (args.containsOption("--out"))
+        args.getFileForOption("--out").replaceWithText(json);
+    else
+        std::cout << json << std::endl;
+
+    if (args.containsOption("--baseline"))
+    {
+        const auto baseline = juce::JSON::parse(args.getFileForOption("--baseline"));
+
+        if (! baseline.isObject())
+        {
+            std::cerr << "couldn't read the baseline" << std::endl;
+            return 1;
+        }
+
+        const auto tolerance = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : 10.0;
+
+        if (compareWithBaseline(results, baseline, tolerance) > 0)
+            return 1;
+    }
+
+    return numSkipped == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Small pieces of host behaviour shared by the command line tools, which run
+// the plugin's processor directly with no DAW around it.
+namespace OfflineHost
+{
+    // Play head with a fixed tempo and a running sample position, so
+    // tempo-synced settings behave as they would under a host's transport
+    class FixedTempoPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        explicit FixedTempoPlayHead(double tempo) : bpm(tempo) {}
+
+        void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+        void rewind() { samplePosition = 0; }
+        void advance(int numSamples) { samplePosition += numSamples; }
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setBpm(bpm);
+            info.setTimeSignature(TimeSignature{});
+            info.setTimeInSamples(samplePosition);
+            info.setTimeInSeconds((double)samplePosition / sampleRate);
+            info.setPpqPosition((double)samplePosition / sampleRate * bpm / 60.0);
+            info.setIsPlaying(true);
+            return info;
+        }
+
+    private:
+        double bpm;
+        double sampleRate = 44100.0;
+        juce::int64 samplePosition = 0;
+    };
+
+    // Gives the processor a matching input/output layout and prepares it, at
+    // double precision if asked, as a host does before prepareToPlay. Fails if
+    // the processor doesn't accept that channel count.
+    inline bool prepare(juce::AudioProcessor& processor, int numChannels, double sampleRate, int blockSize,
+                        bool doublePrecision = false)
+    {
+        const auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+
+        if (channelSet.isDisabled() || ! processor.setBusesLayout(layout))
+            return false;
+
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        return true;
+    }
+
+    inline juce::MemoryBlock loadState(const juce::File& file)
+    {
+        juce::MemoryBlock state;
+
+        if (! file.loadFileAsData(state))
+            state.reset();
+
+        return state;
+    }
+}
\ No newline at end of file
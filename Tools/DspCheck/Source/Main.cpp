@@ -0,0 +1,244 @@
+#include <JuceHeader.h>
+#include "../../../Source/DSP/ConvolutionStage.h"
+#include "../../../Source/DSP/FractionalDelayLine.h"
+
+// Checks the DSP fast paths against the plain code they stand in for.
+//
+//   DspCheck [--seed N]
+//
+// Delay line: readBlock() in every interpolation mode against read() one
+// sample at a time, on two lines fed the same noise. A short ring, delays
+// from the shortest to the longest and runs cut at random lengths take the
+// taps and the write head across the wrap point again and again, which is
+// where the block path has to stop and hand over to read().
+//
+// Convolution: a stereo IR long enough for several FFT partitions, loaded
+// through ConvolutionStage from a temporary file, against direct convolution
+// with the same normalised taps in double. Blocks of random length end at
+// every point of a partition.
+//
+// Each check prints its worst error. The exit code is 1 if any of them is
+// over its tolerance.
+
+namespace
+{
+    using DelayLine = FractionalDelayLine<float>;
+    using Interpolation = DelayLine::Interpolation;
+
+    constexpr int ringSize = 256;
+    constexpr int numDelayTrials = 2000;
+
+    struct CheckResult
+    {
+        const char* name;
+        double worstError;
+        double tolerance;
+    };
+
+    // Largest difference between the two read paths over many random trials
+    template <Interpolation mode>
+    double checkReadBlock(juce::Random& random)
+    {
+        constexpr int numSamples = ringSize * 3;
+
+        std::vector<float> blockRing((size_t)ringSize), sampleRing((size_t)ringSize);
+        std::vector<float> input((size_t)numSamples), blockOutput((size_t)numSamples), sampleOutput((size_t)numSamples);
+        double worst = 0.0;
+
+        for (int trial = 0; trial < numDelayTrials; ++trial)
+        {
+            DelayLine blockLine, sampleLine;
+            std::fill(blockRing.begin(), blockRing.end(), 0.0f);
+            std::fill(sampleRing.begin(), sampleRing.end(), 0.0f);
+            blockLine.setStorage(blockRing.data(), ringSize);
+            sampleLine.setStorage(sampleRing.data(), ringSize);
+
+            // Half the trials close to the shortest delay, where the runs are
+            // shortest, the rest anywhere; a quarter of them on whole samples
+            const auto shortest = (float)DelayLine::minimumDelay;
+            const auto longest = blockLine.getMaxDelay();
+            auto delay = random.nextBool() ? shortest + random.nextFloat() * 6.0f
+                                           : shortest + random.nextFloat() * (longest - shortest);
+
+            if (random.nextInt(4) == 0)
+                delay = std::floor(delay);
+
+            blockLine.setDelay(juce::jmin(delay, longest));
+            sampleLine.setDelay(juce::jmin(delay, longest));
+
+            for (auto& sample : input)
+                sample = random.nextFloat() * 2.0f - 1.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                sampleOutput[(size_t)i] = sampleLine.read<mode>(sampleLine.getCurrentDelay());
+                sampleLine.write(input[(size_t)i]);
+            }
+
+            // The way MultiChannelDelay walks a block: straight runs where it
+            // can, one sample through read() where it can't
+            for (int i = 0; i < numSamples;)
+            {
+                const auto run = blockLine.getContiguousRun(juce::jmin(numSamples - i, 1 + random.nextInt(64)));
+
+                if (run <= 0)
+                {
+                    blockOutput[(size_t)i] = blockLine.read<mode>(blockLine.getCurrentDelay());
+                    blockLine.write(input[(size_t)i]);
+                    ++i;
+                    continue;
+                }
+
+                blockLine.readBlock<mode>(blockOutput.data() + i, run);
+                std::copy_n(input.data() + i, run, blockLine.getWritePointer());
+                blockLine.advanceWrite(run);
+                i += run;
+            }
+
+            for (int i = 0; i < numSamples; ++i)
+                worst = juce::jmax(worst, (double)std::abs(blockOutput[(size_t)i] - sampleOutput[(size_t)i]));
+        }
+
+        return worst;
+    }
+
+    // Largest difference from direct convolution, relative to the output's peak
+    double checkConvolution(juce::Random& random)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numChannels = 2;
+        constexpr int maxBlockSize = 512;
+
+        // The direct part, three whole partitions and a short last one
+        constexpr int irLength = ImpulseResponse::partitionSize * 4 + 100;
+        constexpr int numSamples = irLength * 8;
+
+        // Decaying noise, kept well clear of the level the IR's end is trimmed at
+        juce::AudioBuffer<float> ir(numChannels, irLength);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < irLength; ++i)
+                ir.setSample(channel, i, (0.1f + 0.9f * random.nextFloat()) * (random.nextBool() ? 1.0f : -1.0f)
+                                             * std::exp(-3.0f * (float)i / (float)irLength));
+
+        juce::TemporaryFile irFile(".wav");
+
+        {
+            juce::WavAudioFormat wav;
+            std::unique_ptr<juce::OutputStream> stream(irFile.getFile().createOutputStream());
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+
+            if (stream != nullptr)
+            {
+                // 32 bits is float WAV, so the IR reads back exactly
+                writer.reset(wav.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 32, {}, 0));
+
+                if (writer != nullptr)
+                    stream.release();   // the writer owns it now
+            }
+
+            if (writer == nullptr || ! writer->writeFromAudioSampleBuffer(ir, 0, irLength))
+            {
+                std::cout << "couldn't write " << irFile.getFile().getFullPathName() << std::endl;
+                return std::numeric_limits<double>::infinity();
+            }
+        }
+
+        // Loaded before prepare(), which then waits for the engine as an offline render does
+        ConvolutionStage convolution;
+        convolution.load(irFile.getFile());
+        convolution.prepare({ sampleRate, (juce::uint32)maxBlockSize, (juce::uint32)numChannels }, true);
+
+        const auto status = convolution.getStatus();
+
+        if (status.state != ConvolutionStage::State::ready || status.response->getLength() != irLength)
+        {
+            std::cout << "couldn't load the IR: " << status.message << std::endl;
+            return std::numeric_limits<double>::infinity();
+        }
+
+        convolution.setMix(1.0f);
+
+        // The same unit-energy scaling ImpulseResponse applies
+        double energy = 0.0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            double channelEnergy = 0.0;
+
+            for (int i = 0; i < irLength; ++i)
+                channelEnergy += (double)ir.getSample(channel, i) * ir.getSample(channel, i);
+
+            energy = juce::jmax(energy, channelEnergy);
+        }
+
+        ir.applyGain((float)(1.0 / std::sqrt(energy)));
+
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                input.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        juce::AudioBuffer<float> output(input);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const auto length = juce::jmin(numSamples - start, 1 + random.nextInt(maxBlockSize));
+            auto block = juce::dsp::AudioBlock<float>(output).getSubBlock((size_t)start, (size_t)length);
+            convolution.process(block);
+            start += length;
+        }
+
+        double worst = 0.0, peak = 0.0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* x = input.getReadPointer(channel);
+            const auto* h = ir.getReadPointer(channel);
+
+            for (int n = 0; n < numSamples; ++n)
+            {
+                double expected = 0.0;
+
+                for (int k = 0; k < juce::jmin(irLength, n + 1); ++k)
+                    expected += (double)h[k] * x[n - k];
+
+                worst = juce::jmax(worst, std::abs(expected - output.getSample(channel, n)));
+                peak = juce::jmax(peak, std::abs(expected));
+            }
+        }
+
+        return worst / juce::jmax(peak, 1.0e-12);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue() : juce::Time::currentTimeMillis();
+    std::cout << "seed " << seed << std::endl;
+
+    juce::Random random(seed);
+
+    const CheckResult results[] = {
+        { "readBlock, linear", checkReadBlock<Interpolation::linear>(random), 1.0e-5 },
+        { "readBlock, lagrange", checkReadBlock<Interpolation::lagrange>(random), 1.0e-5 },
+        { "readBlock, thiran", checkReadBlock<Interpolation::thiran>(random), 1.0e-5 },
+        { "partitioned convolution", checkConvolution(random), 1.0e-4 }
+    };
+
+    int numFailed = 0;
+
+    for (auto& result : results)
+    {
+        const bool passed = result.worstError <= result.tolerance;
+        numFailed += passed ? 0 : 1;
+
+        std::cout << result.name << ": worst error " << result.worstError << " (tolerance " << result.tolerance << ")"
+                  << (passed ? "" : "  FAILED") << std::endl;
+    }
+
+    return numFailed == 0 ? 0 : 1;
+}
\ No newline at end of file
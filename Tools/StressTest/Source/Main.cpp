@@ -0,0 +1,249 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/OfflineHost.h"
+
+// Drives processBlock the way an unfriendly host would and checks that the
+// audio callback never allocates, locks or blocks (see RealtimeSafety.h; this
+// tool is built with REALTIME_SAFETY_CHECKS=1).
+//
+//   StressTest [--seconds N] [--seed N] [--double]
+//
+// Each session prepares the processor with a random sample rate, channel count,
+// tempo and maximum block size. An audio thread then calls processBlock with
+// random block sizes up to that maximum, including empty blocks, on noise with
+// occasional silence and overs. The main thread runs the message loop, so the
+// processor's timer fires as it would in a host. Meanwhile a control thread
+// moves random parameters, half of them itself like host automation and half
+// through the message thread like an editor, so stages switched on mid-session
+// claim and attach their memory while audio runs. Now and then it loads one of
+// a few saved states through the message thread, and it drains the meter feed
+// like an open editor would. With --double every session runs at double
+// precision, through the processor's double processBlock.
+//
+// The exit code is 1 if any real-time violation or non-finite output sample
+// was seen.
+
+namespace
+{
+    class ControlThread : public juce::Thread
+    {
+    public:
+        ControlThread(juce::AudioProcessor& processorToDrive, MeterFeed& feedToDrain,
+                      const juce::Array<juce::MemoryBlock>& statesToLoad, juce::int64 seed)
+            : juce::Thread("Stress control"),
+              processor(processorToDrive),
+              meterFeed(feedToDrain),
+              states(statesToLoad),
+              random(seed),
+              frames(MeterFeed::frameCapacity),
+              scopePoints(MeterFeed::scopeCapacity)
+        {
+        }
+
+        void run() override
+        {
+            const auto& parameters = processor.getParameters();
+
+            while (! threadShouldExit())
+            {
+                if (random.nextInt(200) == 0)
+                {
+                    juce::MessageManager::callAsync([&processor = processor, &state = states.getReference(random.nextInt(states.size()))]
+                    {
+                        processor.setStateInformation(state.getData(), (int)state.getSize());
+                    });
+
+                    ++numStateLoads;
+                }
+                else
+                {
+                    auto* parameter = parameters[random.nextInt(parameters.size())];
+                    const auto value = random.nextFloat();
+
+                    if (random.nextBool())
+                        juce::MessageManager::callAsync([parameter, value] { parameter->setValueNotifyingHost(value); });
+                    else
+                        parameter->setValueNotifyingHost(value);
+
+                    ++numParameterChanges;
+                }
+
+                meterFeed.readFrames(frames.data(), (int)frames.size());
+                meterFeed.readScope(scopePoints.data(), (int)scopePoints.size());
+
+                wait(1);
+            }
+        }
+
+        std::atomic<int> numParameterChanges { 0 }, numStateLoads { 0 };
+
+    private:
+        juce::AudioProcessor& processor;
+        MeterFeed& meterFeed;
+        const juce::Array<juce::MemoryBlock>& states;
+        juce::Random random;
+        std::vector<MeterFeed::Frame> frames;
+        std::vector<MeterFeed::ScopePoint> scopePoints;
+    };
+
+    // A handful of states with every parameter randomised, made up front so
+    // the control thread only ever loads them
+    juce::Array<juce::MemoryBlock> makeRandomStates(juce::AudioProcessor& processor, juce::Random& random, int count)
+    {
+        juce::Array<juce::MemoryBlock> states;
+
+        for (int i = 0; i < count; ++i)
+        {
+            for (auto* parameter : processor.getParameters())
+                parameter->setValueNotifyingHost(random.nextFloat());
+
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+            states.add(state);
+        }
+
+        return states;
+    }
+
+    // Feeds random blocks to a prepared processor until sessionEnd, counting
+    // them and any non-finite output samples
+    template <typename SampleType>
+    void runSession(juce::AudioProcessor& processor, OfflineHost::FixedTempoPlayHead& playHead, juce::Random& random,
+                    int numChannels, int maxBlockSize, double sessionEnd, juce::int64& numBlocks, juce::int64& numNonFinite)
+    {
+        juce::AudioBuffer<SampleType> buffer(numChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+
+        while (juce::Time::getMillisecondCounterHiRes() < sessionEnd)
+        {
+            const auto numSamples = random.nextInt(maxBlockSize + 1);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+
+            const auto level = random.nextInt(20) == 0 ? (random.nextBool() ? 0.0f : 4.0f) : 0.5f;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < numSamples; ++sample)
+                    buffer.setSample(channel, sample, (SampleType)((random.nextFloat() * 2.0f - 1.0f) * level));
+
+            processor.processBlock(buffer, midi);
+            playHead.advance(numSamples);
+            ++numBlocks;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < numSamples; ++sample)
+                    if (! std::isfinite(buffer.getSample(channel, sample)))
+                        ++numNonFinite;
+        }
+    }
+
+    // Prepares the processor for one random session after another until
+    // endTime, running each on this thread as its audio thread, then stops the
+    // message loop
+    class AudioThread : public juce::Thread
+    {
+    public:
+        AudioThread(_3ff3ctsAudioProcessor& processorToDrive, juce::int64 seed, double endTimeMs, bool useDoublePrecision)
+            : juce::Thread("Stress audio"),
+              processor(processorToDrive),
+              random(seed),
+              endTime(endTimeMs),
+              doublePrecision(useDoublePrecision)
+        {
+        }
+
+        void run() override
+        {
+            const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+            juce::AudioProcessor& host = processor;
+
+            while (juce::Time::getMillisecondCounterHiRes() < endTime)
+            {
+                const auto sampleRate = sampleRates[random.nextInt((int)std::size(sampleRates))];
+                const auto numChannels = 1 + random.nextInt(2);
+                const auto maxBlockSize = 16 + random.nextInt(2033);
+
+                OfflineHost::FixedTempoPlayHead playHead(40.0 + random.nextDouble() * 200.0);
+                playHead.setSampleRate(sampleRate);
+                processor.setPlayHead(&playHead);
+
+                if (! OfflineHost::prepare(processor, numChannels, sampleRate, maxBlockSize, doublePrecision))
+                {
+                    std::cout << "prepare failed for " << numChannels << " channels" << std::endl;
+                    prepareFailed = true;
+                    processor.setPlayHead(nullptr);
+                    break;
+                }
+
+                ++numSessions;
+                const auto sessionEnd = juce::jmin(endTime, juce::Time::getMillisecondCounterHiRes() + 2000.0);
+
+                if (doublePrecision)
+                    runSession<double>(host, playHead, random, numChannels, maxBlockSize, sessionEnd, numBlocks, numNonFinite);
+                else
+                    runSession<float>(host, playHead, random, numChannels, maxBlockSize, sessionEnd, numBlocks, numNonFinite);
+
+                processor.releaseResources();
+                processor.setPlayHead(nullptr);
+            }
+
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        }
+
+        juce::int64 numBlocks = 0, numNonFinite = 0;
+        int numSessions = 0;
+        bool prepareFailed = false;
+
+    private:
+        _3ff3ctsAudioProcessor& processor;
+        juce::Random random;
+        double endTime;
+        bool doublePrecision;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    const auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 30.0;
+    const auto seed = args.containsOption("--seed") ? args.getValueForOption("--seed").getLargeIntValue() : juce::Time::currentTimeMillis();
+    const bool doublePrecision = args.containsOption("--double");
+
+#if ! REALTIME_SAFETY_CHECKS
+    std::cout << "warning: built without REALTIME_SAFETY_CHECKS, only output is checked" << std::endl;
+#endif
+
+    std::cout << "seed " << seed << std::endl;
+
+    juce::Random random(seed);
+    _3ff3ctsAudioProcessor processor;
+    juce::AudioProcessor& host = processor;
+
+    const auto states = makeRandomStates(host, random, 4);
+    processor.getMeterFeed().setActive(true);
+    ControlThread control(host, processor.getMeterFeed(), states, seed + 1);
+    AudioThread audio(processor, seed + 2, juce::Time::getMillisecondCounterHiRes() + seconds * 1000.0, doublePrecision);
+
+    control.startThread();
+    audio.startThread();
+
+    // This thread is the message thread: it runs the processor's timer and the
+    // control thread's posted changes until the audio thread is done
+    juce::MessageManager::getInstance()->runDispatchLoop();
+
+    audio.stopThread(-1);
+    control.stopThread(1000);
+
+    if (audio.prepareFailed)
+        return 1;
+
+    const auto numViolations = RealtimeSafety::getNumViolations();
+
+    std::cout << audio.numBlocks << " blocks in " << audio.numSessions << " sessions, "
+              << control.numParameterChanges.load() << " parameter changes, "
+              << control.numStateLoads.load() << " state loads" << std::endl;
+    std::cout << numViolations << " real-time violations, " << audio.numNonFinite << " non-finite samples" << std::endl;
+
+    return numViolations == 0 && audio.numNonFinite == 0 ? 0 : 1;
+}
\ No newline at end of file